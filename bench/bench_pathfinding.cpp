@@ -0,0 +1,277 @@
+#include "corpus.h"
+#include "../include/pathfinding/pathfinder.h"
+#include "../include/pathfinding/batch.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+/*
+	Runs every engine over a fixed, seeded corpus of generated maps and prints one
+	row per (map, engine) pair as CSV or JSON lines, so runs can be diffed between commits.
+
+	Usage: bench_pathfinding [--max-size=4096] [--engines=bfs,astar] [--format=csv|json] [--seed=1] [--threads=0] [--landmarks=8]
+		[--open-lists=binary,4ary,pairing,bucket]
+
+	--threads answers each map's queries as one parallel batch, 0 uses every hardware thread.
+	Seconds are then wall time for the whole batch.
+
+	--landmarks sets how many landmarks the alt engine places, building the table is part of its warmup.
+
+	--open-lists runs the astar and alt engines once per open list, binary by default.
+	Other engines have a fixed open list and print "-" in the open_list column.
+*/
+
+using namespace engine;
+using namespace engine::pathfinding;
+
+namespace {
+
+	struct Options
+	{
+		int maxSize{ 4096 };
+		std::uint32_t seed{ 1 };
+		bool json{};
+		// Solve queries with the batch solver, -1 runs them one by one
+		int threads{ -1 };
+		std::size_t landmarks{ 8 };
+		std::vector<PathfindingMethod> methods{};
+		std::vector<OpenListKind> openLists{};
+	};
+
+	struct Row
+	{
+		// First query, which includes any preprocessing the engine caches for the map
+		double warmupSeconds{};
+		std::size_t queries{};
+		std::size_t found{};
+		double seconds{};
+		std::size_t expanded{};
+		// Path costs compared with the Dial reference, which are lengths except on terrain maps
+		std::size_t optimal{};
+		double lengthRatio{};
+		// Largest SearchStats::peakMemory of any query, what one engine's buffers held for this map
+		std::size_t engineMemoryKb{};
+	};
+
+	bool parseMethod(const std::string& name, PathfindingMethod& method)
+	{
+		for (int i{}; i < PathfindingMethodCount; i++) {
+			if (name == methodName(static_cast<PathfindingMethod>(i))) {
+				method = static_cast<PathfindingMethod>(i);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool parseOpenList(const std::string& name, OpenListKind& kind)
+	{
+		for (int i{}; i < static_cast<int>(OpenListKind::OpenListKindCount); i++) {
+			if (name == openListName(static_cast<OpenListKind>(i))) {
+				kind = static_cast<OpenListKind>(i);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// Engines whose open list can be picked
+	bool takesOpenList(PathfindingMethod method) { return method == AStar || method == Landmarks; }
+
+	bool parseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i{ 1 }; i < argc; i++) {
+			std::string argument = argv[i];
+			std::string value = argument.substr(argument.find('=') + 1);
+
+			if (argument.rfind("--max-size=", 0) == 0) options.maxSize = std::stoi(value);
+			else if (argument.rfind("--seed=", 0) == 0) options.seed = static_cast<std::uint32_t>(std::stoul(value));
+			else if (argument.rfind("--format=", 0) == 0) options.json = value == "json";
+			else if (argument.rfind("--threads=", 0) == 0) options.threads = std::stoi(value);
+			else if (argument.rfind("--landmarks=", 0) == 0) options.landmarks = std::stoul(value);
+			else if (argument.rfind("--engines=", 0) == 0) {
+				std::size_t first{};
+
+				while (first <= value.size()) {
+					std::size_t last = std::min(value.find(',', first), value.size());
+					PathfindingMethod method{};
+
+					if (!parseMethod(value.substr(first, last - first), method)) {
+						std::fprintf(stderr, "Unknown engine '%s'\n", value.substr(first, last - first).c_str());
+						return false;
+					}
+
+					options.methods.push_back(method);
+					first = last + 1;
+				}
+			}
+			else if (argument.rfind("--open-lists=", 0) == 0) {
+				std::size_t first{};
+
+				while (first <= value.size()) {
+					std::size_t last = std::min(value.find(',', first), value.size());
+					OpenListKind kind{};
+
+					if (!parseOpenList(value.substr(first, last - first), kind)) {
+						std::fprintf(stderr, "Unknown open list '%s'\n", value.substr(first, last - first).c_str());
+						return false;
+					}
+
+					options.openLists.push_back(kind);
+					first = last + 1;
+				}
+			}
+			else {
+				std::fprintf(stderr, "Usage: %s [--max-size=4096] [--engines=bfs,astar] [--format=csv|json] [--seed=1] [--threads=0] [--landmarks=8] [--open-lists=binary,4ary,pairing,bucket]\n", argv[0]);
+				return false;
+			}
+		}
+
+		if (options.methods.empty()) {
+			for (int i{}; i < PathfindingMethodCount; i++) options.methods.push_back(static_cast<PathfindingMethod>(i));
+		}
+
+		if (options.openLists.empty()) options.openLists.push_back(OpenListKind::BinaryHeap);
+
+		return true;
+	}
+
+	void printHeader(const Options& options)
+	{
+		if (!options.json)
+			std::printf("map,family,rows,columns,engine,open_list,warmup_seconds,queries,found,seconds,queries_per_second,expanded,ns_per_expanded,optimal,length_ratio,engine_memory_kb\n");
+	}
+
+	void printRow(const Options& options, const bench::MapSpec& spec, PathfindingMethod method, const char* openList, const Row& row)
+	{
+		double queriesPerSecond = row.seconds > 0 ? row.queries / row.seconds : 0;
+		double nsPerExpanded = row.expanded > 0 ? row.seconds * 1e9 / row.expanded : 0;
+		const char* format = options.json
+			? "{\"map\":\"%s\",\"family\":\"%s\",\"rows\":%d,\"columns\":%d,\"engine\":\"%s\",\"open_list\":\"%s\",\"warmup_seconds\":%.6f,\"queries\":%zu,\"found\":%zu,\"seconds\":%.6f,"
+				"\"queries_per_second\":%.2f,\"expanded\":%zu,\"ns_per_expanded\":%.3f,\"optimal\":%zu,\"length_ratio\":%.6f,\"engine_memory_kb\":%zu}\n"
+			: "%s,%s,%d,%d,%s,%s,%.6f,%zu,%zu,%.6f,%.2f,%zu,%.3f,%zu,%.6f,%zu\n";
+
+		std::printf(format, spec.name().c_str(), spec.family.c_str(), spec.rows, spec.columns, methodName(method), openList,
+			row.warmupSeconds, row.queries, row.found, row.seconds, queriesPerSecond, row.expanded, nsPerExpanded, row.optimal, row.lengthRatio, row.engineMemoryKb);
+		std::fflush(stdout);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options{};
+	if (!parseOptions(argc, argv, options)) return 1;
+
+	printHeader(options);
+
+	Pathfinder pathfinder{};
+	SearchResult result{};
+
+	std::unique_ptr<BatchSolver> solver{};
+	std::vector<PathQuery> batch{};
+	std::vector<SearchResult> results{};
+
+	pathfinder.setLandmarkCount(options.landmarks);
+
+	if (options.threads >= 0) {
+		solver = std::make_unique<BatchSolver>(options.threads);
+		solver->setLandmarkCount(options.landmarks);
+	}
+
+	for (const auto& spec : bench::corpusSpecs(options.maxSize)) {
+		std::fprintf(stderr, "%s\n", spec.name().c_str());
+
+		auto corpus = bench::generate(spec, options.seed);
+		Map& map = corpus.map;
+
+		// Reference costs, -1 when the finish is unreachable
+		std::vector<long long> reference{};
+		for (const auto& query : corpus.queries) {
+			map.setStart(query.start);
+			map.setFinish(query.finish);
+			pathfinder.findPath(map, Dial, result);
+			reference.push_back(result.found ? static_cast<long long>(map.pathCost(result.path)) : -1);
+		}
+
+		for (auto method : options.methods) {
+			// Engines with a fixed open list run once
+			std::size_t runs = takesOpenList(method) ? options.openLists.size() : 1;
+
+			for (std::size_t run{}; run < runs; run++) {
+				OpenListKind openList = options.openLists[run];
+				pathfinder.setOpenList(openList);
+				if (solver) solver->setOpenList(openList);
+
+				Row row{};
+				double lengthSum{};
+
+				// Compare one result with the Dial reference
+				auto account = [&](std::size_t i, const SearchResult& result) {
+					row.queries++;
+					row.expanded += result.checked.size();
+					row.engineMemoryKb = std::max<std::size_t>(row.engineMemoryKb, static_cast<std::size_t>(result.stats.peakMemory / 1024));
+
+					if (result.found != (reference[i] >= 0)) return;
+
+					if (!result.found) {
+						row.optimal++;
+						return;
+					}
+
+					// Engines that ignore terrain still walk through it, price their paths on the map
+					map.setStart(corpus.queries[i].start);
+					map.setFinish(corpus.queries[i].finish);
+					auto cost = static_cast<long long>(map.pathCost(result.path));
+
+					row.found++;
+					if (cost == reference[i]) row.optimal++;
+					lengthSum += reference[i] > 0 ? static_cast<double>(cost) / reference[i] : 1.0;
+				};
+
+				if (solver) {
+					batch.clear();
+					for (const auto& query : corpus.queries) batch.push_back({ query.start, query.finish, method });
+
+					// Every worker builds its own copy of any cached preprocessing
+					auto warmup = std::chrono::steady_clock::now();
+					solver->solve(map, batch, results);
+					row.warmupSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - warmup).count();
+
+					auto begin = std::chrono::steady_clock::now();
+					solver->solve(map, batch, results);
+					row.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+					for (std::size_t i{}; i < results.size(); i++) account(i, results[i]);
+				}
+				else {
+					map.setStart(corpus.queries[0].start);
+					map.setFinish(corpus.queries[0].finish);
+
+					auto warmup = std::chrono::steady_clock::now();
+					pathfinder.findPath(map, method, result);
+					row.warmupSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - warmup).count();
+
+					for (std::size_t i{}; i < corpus.queries.size(); i++) {
+						map.setStart(corpus.queries[i].start);
+						map.setFinish(corpus.queries[i].finish);
+
+						auto begin = std::chrono::steady_clock::now();
+						pathfinder.findPath(map, method, result);
+						row.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+						account(i, result);
+					}
+				}
+
+				row.lengthRatio = row.found > 0 ? lengthSum / row.found : 1.0;
+				printRow(options, spec, method, takesOpenList(method) ? openListName(openList) : "-", row);
+			}
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,35 @@
+#include "../include/pathfinding/movingai.h"
+
+#include <cstdio>
+
+/*
+	Converts a MovingAI .map file into a chunked map file, which ChunkedMap opens
+	without reading it. The .map is streamed a band of rows at a time, so maps
+	larger than memory can be converted.
+
+	Usage: convert_map <file.map> <file.chunks>
+*/
+
+using namespace engine::pathfinding;
+
+int main(int argc, char** argv)
+{
+	if (argc < 3) {
+		std::fprintf(stderr, "Usage: %s <file.map> <file.chunks>\n", argv[0]);
+		return 1;
+	}
+
+	if (!convertMovingAiMap(argv[1], argv[2])) {
+		std::fprintf(stderr, "Can't convert '%s' to '%s'\n", argv[1], argv[2]);
+		return 1;
+	}
+
+	ChunkedMap map{};
+	if (!map.open(argv[2])) {
+		std::fprintf(stderr, "Can't open the converted map '%s'\n", argv[2]);
+		return 1;
+	}
+
+	std::fprintf(stderr, "%s: %dx%d tiles\n", argv[2], map.rows(), map.columns());
+	return 0;
+}
@@ -0,0 +1,219 @@
+#include "corpus.h"
+
+namespace engine {
+	namespace bench {
+
+		using pathfinding::Map;
+		using pathfinding::Position;
+
+		namespace {
+
+			// Larger maps get fewer queries so every map costs roughly the same
+			constexpr std::size_t tilesPerCorpusMap{ 8 * 1024 * 1024 };
+			constexpr std::size_t maxQueries{ 200 };
+			constexpr std::size_t minQueries{ 4 };
+
+			constexpr int roomSize{ 16 };
+
+			// std::uniform_int_distribution differs between standard libraries, this gives the same maps everywhere
+			int uniform(std::mt19937& random, int min, int max)
+			{
+				const std::uint32_t range = static_cast<std::uint32_t>(max - min) + 1;
+				// Drop the lowest 2^32 % range outputs so every value is equally likely
+				const std::uint32_t threshold = (0u - range) % range;
+
+				for (;;) {
+					auto value = static_cast<std::uint32_t>(random());
+					if (value >= threshold) return min + static_cast<int>(value % range);
+				}
+			}
+
+			// 32-bit FNV-1a, std::hash is implementation defined
+			std::uint32_t hashName(const std::string& name)
+			{
+				std::uint32_t hash{ 2166136261u };
+
+				for (char character : name) {
+					hash ^= static_cast<std::uint8_t>(character);
+					hash *= 16777619u;
+				}
+
+				return hash;
+			}
+
+			void setAll(Map& map, bool walkable)
+			{
+				for (int row{}; row < map.rows(); row++)
+					for (int column{}; column < map.columns(); column++)
+						map.setWalkable({ row, column }, walkable);
+			}
+
+			void noise(Map& map, int coverage, std::mt19937& random)
+			{
+				for (int row{}; row < map.rows(); row++)
+					for (int column{}; column < map.columns(); column++)
+						map.setWalkable({ row, column }, uniform(random, 1, 100) > coverage);
+			}
+
+			// Perfect maze with one tile wide corridors, carved by an iterative depth first walk
+			void maze(Map& map, std::mt19937& random)
+			{
+				setAll(map, false);
+
+				const int cellRows = (map.rows() + 1) / 2;
+				const int cellColumns = (map.columns() + 1) / 2;
+				std::vector<bool> carved(static_cast<std::size_t>(cellRows) * cellColumns, false);
+				std::vector<Position> stack{ { 0, 0 } };
+
+				carved[0] = true;
+				map.setWalkable({ 0, 0 }, true);
+
+				constexpr std::array<int, 4> rowSteps{ 0, 0, -1, 1 };
+				constexpr std::array<int, 4> columnSteps{ -1, 1, 0, 0 };
+
+				while (!stack.empty()) {
+					Position cell = stack.back();
+					std::array<int, 4> options{};
+					int optionCount{};
+
+					for (int i{}; i < 4; i++) {
+						Position next{ cell.row + rowSteps[i], cell.column + columnSteps[i] };
+
+						if (next.row >= 0 && next.row < cellRows && next.column >= 0 && next.column < cellColumns
+							&& !carved[static_cast<std::size_t>(next.row) * cellColumns + next.column])
+							options[optionCount++] = i;
+					}
+
+					if (optionCount == 0) {
+						stack.pop_back();
+						continue;
+					}
+
+					int direction = options[uniform(random, 0, optionCount - 1)];
+					Position next{ cell.row + rowSteps[direction], cell.column + columnSteps[direction] };
+
+					carved[static_cast<std::size_t>(next.row) * cellColumns + next.column] = true;
+					map.setWalkable({ cell.row * 2 + rowSteps[direction], cell.column * 2 + columnSteps[direction] }, true);
+					map.setWalkable({ next.row * 2, next.column * 2 }, true);
+					stack.push_back(next);
+				}
+			}
+
+			// Square rooms separated by walls, every wall between two rooms has a door
+			void rooms(Map& map, std::mt19937& random)
+			{
+				setAll(map, true);
+
+				for (int row{ roomSize }; row < map.rows(); row += roomSize)
+					for (int column{}; column < map.columns(); column++) map.setWalkable({ row, column }, false);
+
+				for (int column{ roomSize }; column < map.columns(); column += roomSize)
+					for (int row{}; row < map.rows(); row++) map.setWalkable({ row, column }, false);
+
+				// Doors never sit on a wall crossing, where they would not connect anything
+				for (int row{ roomSize }; row < map.rows(); row += roomSize) {
+					for (int column{}; column + 1 < map.columns(); column += roomSize) {
+						int last = std::min(column + roomSize, map.columns()) - 1;
+						map.setWalkable({ row, uniform(random, column + 1, last) }, true);
+					}
+				}
+
+				for (int column{ roomSize }; column < map.columns(); column += roomSize) {
+					for (int row{}; row + 1 < map.rows(); row += roomSize) {
+						int last = std::min(row + roomSize, map.rows()) - 1;
+						map.setWalkable({ uniform(random, row + 1, last), column }, true);
+					}
+				}
+			}
+
+			// Light noise over patches of terrain, half of them plain ground and the rest costing 2 to 255
+			void terrain(Map& map, std::mt19937& random)
+			{
+				noise(map, 10, random);
+
+				for (int row{}; row < map.rows(); row += roomSize) {
+					for (int column{}; column < map.columns(); column += roomSize) {
+						int cost = uniform(random, 0, 1) ? 1 : uniform(random, 2, Map::maxCost);
+
+						for (int r{ row }; r < std::min(row + roomSize, map.rows()); r++)
+							for (int c{ column }; c < std::min(column + roomSize, map.columns()); c++)
+								if (map.isWalkable(map.id(r, c))) map.setCost({ r, c }, static_cast<std::uint8_t>(cost));
+					}
+				}
+			}
+
+			Position randomOpenTile(const Map& map, std::mt19937& random, int firstColumn, int lastColumn)
+			{
+				for (;;) {
+					Position tile{ uniform(random, 0, map.rows() - 1), uniform(random, firstColumn, lastColumn) };
+
+					if (map.isWalkable(map.id(tile))) return tile;
+				}
+			}
+		}
+
+		std::string MapSpec::name() const
+		{
+			std::string result = family;
+
+			if (family == "noise") result += std::to_string(parameter);
+
+			return result + "-" + std::to_string(rows) + "x" + std::to_string(columns);
+		}
+
+		std::vector<MapSpec> corpusSpecs(int maxSize)
+		{
+			const std::array<std::pair<int, int>, 5> sizes{ { { 10, 20 }, { 64, 64 }, { 256, 256 }, { 1024, 1024 }, { 4096, 4096 } } };
+			std::vector<MapSpec> specs{};
+
+			for (auto [rows, columns] : sizes) {
+				if (std::max(rows, columns) > maxSize) continue;
+
+				specs.push_back({ "open", rows, columns });
+				for (int coverage : { 10, 25, 40 }) specs.push_back({ "noise", rows, columns, coverage });
+				specs.push_back({ "maze", rows, columns });
+				specs.push_back({ "rooms", rows, columns });
+				specs.push_back({ "unreachable", rows, columns });
+				specs.push_back({ "terrain", rows, columns });
+			}
+
+			return specs;
+		}
+
+		CorpusMap generate(const MapSpec& spec, std::uint32_t seed)
+		{
+			// Mix the spec into the seed so each map is independent of the corpus order
+			std::seed_seq sequence{ seed, static_cast<std::uint32_t>(spec.rows), static_cast<std::uint32_t>(spec.columns),
+				static_cast<std::uint32_t>(spec.parameter), hashName(spec.family) };
+			std::mt19937 random{ sequence };
+
+			CorpusMap corpus{ spec, Map{ spec.rows, spec.columns } };
+			Map& map = corpus.map;
+
+			if (spec.family == "noise") noise(map, spec.parameter, random);
+			else if (spec.family == "maze") maze(map, random);
+			else if (spec.family == "rooms") rooms(map, random);
+			else if (spec.family == "terrain") terrain(map, random);
+			else if (spec.family == "unreachable") {
+				// A full wall down the middle, queries always cross it
+				for (int row{}; row < map.rows(); row++) map.setWalkable({ row, map.columns() / 2 }, false);
+			}
+
+			std::size_t tiles = static_cast<std::size_t>(spec.rows) * spec.columns;
+			std::size_t queryCount = std::clamp(tilesPerCorpusMap / tiles, minQueries, maxQueries);
+
+			for (std::size_t i{}; i < queryCount; i++) {
+				if (spec.family == "unreachable") {
+					corpus.queries.push_back({ randomOpenTile(map, random, 0, map.columns() / 2 - 1),
+						randomOpenTile(map, random, map.columns() / 2 + 1, map.columns() - 1) });
+				}
+				else {
+					corpus.queries.push_back({ randomOpenTile(map, random, 0, map.columns() - 1),
+						randomOpenTile(map, random, 0, map.columns() - 1) });
+				}
+			}
+
+			return corpus;
+		}
+	}
+}
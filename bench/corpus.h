@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../include/pathfinding/map.h"
+
+#include <string>
+#include <random>
+
+namespace engine {
+	namespace bench {
+
+		// One generated map family at one size
+		struct MapSpec
+		{
+			std::string family{};
+			int rows{};
+			int columns{};
+			// Family specific, obstacle percentage for noise maps
+			int parameter{};
+
+			std::string name() const;
+		};
+
+		struct Query
+		{
+			pathfinding::Position start{};
+			pathfinding::Position finish{};
+		};
+
+		struct CorpusMap
+		{
+			MapSpec spec{};
+			pathfinding::Map map;
+			std::vector<Query> queries{};
+		};
+
+		// Every map of the corpus up to the given side length, from 10x20 to 4096x4096
+		std::vector<MapSpec> corpusSpecs(int maxSize);
+
+		// Maps and queries only depend on the spec and the seed
+		CorpusMap generate(const MapSpec& spec, std::uint32_t seed);
+	}
+}
@@ -0,0 +1,89 @@
+#include "../include/pathfinding/movingai.h"
+
+#include <cstdio>
+#include <string>
+
+/*
+	Runs a MovingAI .scen file against its .map with one engine and prints a CSV row
+	per scenario followed by a summary on stderr. Exits with 1 if any result
+	doesn't match its reference length. Engines that support diagonal moves use the
+	given movement (4, 8, 8-no-squeezing or 8-no-cutting), 8-no-cutting is what the
+	.scen reference lengths assume.
+
+	Usage: run_scenarios <file.map> <file.scen> [engine] [movement]
+*/
+
+using namespace engine::pathfinding;
+
+int main(int argc, char** argv)
+{
+	if (argc < 3) {
+		std::fprintf(stderr, "Usage: %s <file.map> <file.scen> [engine] [movement]\n", argv[0]);
+		return 1;
+	}
+
+	PathfindingMethod method{ AStar };
+
+	if (argc > 3) {
+		std::string name = argv[3];
+		int i{};
+
+		while (i < PathfindingMethodCount && name != methodName(static_cast<PathfindingMethod>(i))) i++;
+
+		if (i == PathfindingMethodCount) {
+			std::fprintf(stderr, "Unknown engine '%s'\n", argv[3]);
+			return 1;
+		}
+
+		method = static_cast<PathfindingMethod>(i);
+	}
+
+	Movement movement{ Movement::FourConnected };
+
+	if (argc > 4) {
+		std::string name = argv[4];
+		int i{};
+
+		while (i < static_cast<int>(Movement::MovementCount) && name != movementName(static_cast<Movement>(i))) i++;
+
+		if (i == static_cast<int>(Movement::MovementCount)) {
+			std::fprintf(stderr, "Unknown movement '%s'\n", argv[4]);
+			return 1;
+		}
+
+		movement = static_cast<Movement>(i);
+	}
+
+	Map map{ 1, 1 };
+	std::vector<Scenario> scenarios{};
+
+	if (!loadMovingAiMap(argv[1], map)) {
+		std::fprintf(stderr, "Can't load map '%s'\n", argv[1]);
+		return 1;
+	}
+
+	if (!loadMovingAiScenarios(argv[2], scenarios)) {
+		std::fprintf(stderr, "Can't load scenarios '%s'\n", argv[2]);
+		return 1;
+	}
+
+	Pathfinder pathfinder{};
+	pathfinder.setMovement(movement);
+	auto report = runScenarios(map, scenarios, method, pathfinder);
+
+	std::printf("index,bucket,start_x,start_y,goal_x,goal_y,octile_reference,reference,length,expanded,microseconds,valid\n");
+
+	for (std::size_t i{}; i < scenarios.size(); i++) {
+		const auto& scenario = scenarios[i];
+		const auto& outcome = report.outcomes[i];
+
+		std::printf("%zu,%d,%d,%d,%d,%d,%.4f,%.4f,%.4f,%zu,%.3f,%d\n", i, scenario.bucket,
+			scenario.start.column, scenario.start.row, scenario.finish.column, scenario.finish.row,
+			scenario.optimalLength, outcome.referenceLength, outcome.length, outcome.expanded, outcome.seconds * 1e6, outcome.valid);
+	}
+
+	std::fprintf(stderr, "%s: %zu scenarios, %zu solved, %zu failed, %.3f ms, %.1f queries/s\n", methodName(method),
+		scenarios.size(), report.solved, report.failed, report.seconds * 1e3, report.seconds > 0 ? scenarios.size() / report.seconds : 0.0);
+
+	return report.failed == 0 ? 0 : 1;
+}
@@ -1,47 +1,65 @@
 
 #include "resources.h"
+#include "settings.h"
+#include "pathfinding/movingai.h"
+#include "pathfinding/trace.h"
+#include "pathfinding/stats.h"
+#include "pathfinding/history.h"
 
 namespace engine {
 
-		struct Tile
-		{
-			sf::Vector2i position{};
-			double gCost, hCost{};
-			std::shared_ptr<Tile> parent{};
-
-			Tile() = default;
-
-			Tile(sf::Vector2i& pos, double g, double h, std::shared_ptr<Tile> p) : position{pos}, gCost{g}, hCost{h}, parent{p}
-			{}
-
-			double fCost() const { return gCost + hCost; };
-		};
-
-		enum PathfindingMethod {
-			BreadthFirst,
-			AStar
-		};
+		using pathfinding::PathfindingMethod;
 
 		class Grid{
 		public:
 
 			Grid(const sf::Vector2f& size, int rows, int columns);
+			~Grid();
+
+			// Replace the map with an empty one of the given size
+			void resize(int rows, int columns);
+			// Load a MovingAI .map file, returns false if it can't be read
+			bool loadMap(const std::string& path);
+			// Show the window of a chunked map starting at corner, only the chunks under it are read
+			bool loadChunkedMap(const std::string& path, pathfinding::Position corner = {});
 
 			void render();
 			void update();
 
 			void findPath(PathfindingMethod method);
+			// Moves for the methods that support diagonals, clears the current search
+			void setMovement(pathfinding::Movement movement);
+			// Show every checked tile and the path at once
+			void skipAnimation();
+			// Move the animation to a point in the trace, from 0 to 1
+			void seek(float position);
+
+			// Save the finished search with its map and path, returns false if there's none or it can't be written
+			bool saveTrace(const std::string& path) const;
+			// Replay a trace file, replacing the map with the one it was recorded on
+			bool loadTrace(const std::string& path);
+
+			// Write the stats of every search finished so far, as JSON for a .json path and CSV otherwise
+			bool exportStats(const std::string& path) const;
 
 			void clearPath();
 			void clearGrid();
 			void fillGrid();
 			void randomGrid();
 
+			// Step through the edit history, one brush stroke, drag or bulk edit at a time
+			bool undo();
+			bool redo();
+
 			// Events
 			void leftClick(sf::Vector2i& mousePos);
 			void leftReleased(sf::Vector2i& mousePos);
 			void rightClick();
 			void rightReleased();
+			// Zoom in for positive delta, keeping the tile under the mouse in place
+			void zoom(float delta, const sf::Vector2i& mousePos);
+			void middleClick(const sf::Vector2i& mousePos);
+			void middleReleased();
 
 		private:
 
@@ -50,22 +68,100 @@ namespace engine {
 			sf::Vector2f m_gridSize{};
 
 			// Tiles
-			std::vector<std::vector<char>> m_tiles{};
-			sf::Vector2i m_startTile{};
-			sf::Vector2i m_finishTile{};
+			pathfinding::Map m_map;
 			sf::Vector2f m_tileSize{};
 			int m_rows{};
 			int m_columns{};
 
+			// What a tile shows on top of its map state, path wins over checked
+			enum TileOverlay : std::uint8_t { NoOverlay = 0, CheckedOverlay = 1, PathOverlay = 2 };
+
+			// Camera over the grid, its viewport is the grid rectangle on screen
+			sf::View m_camera{};
+			bool m_panning{};
+			// World point held under the mouse while panning
+			sf::Vector2f m_panAnchor{};
+
+			// Tiles in view are two triangles each in one vertex array, rebuilt when the camera
+			// moves. Otherwise a tile's colours are only rewritten when its state changes and
+			// just the changed tiles are uploaded to the vertex buffer before the next draw.
+			std::vector<sf::Vertex> m_vertices{};
+			sf::VertexBuffer m_tileBuffer{ sf::Triangles, sf::VertexBuffer::Dynamic };
+			bool m_useBuffer{};
+			// Visible tiles as (column, row, columns, rows)
+			sf::IntRect m_visibleTiles{};
+			// Set when the camera moved and the visible vertices have to be rebuilt
+			bool m_rebuildTiles{ true };
+			std::vector<int> m_dirtyTiles{};
+
+			// Zoomed out, the map is drawn from textures with one texel per tile. Pages are
+			// built the first time they're needed and then patched like the vertices.
+			struct TexturePage
+			{
+				sf::Texture texture{};
+				sf::IntRect tiles{};
+				// Texels to redraw in page coordinates, empty once the texture is current
+				sf::IntRect dirty{};
+			};
+
+			std::vector<std::unique_ptr<TexturePage>> m_pages{};
+			int m_pageSize{};
+			int m_pageColumns{};
+			std::vector<pathfinding::TileId> m_dirtyTexels{};
+			// Past this many changed tiles the rectangle around them in each page is redrawn instead
+			static constexpr std::size_t maxTexelUpdates{ 4096 };
+
+			// Indexed by TileId
+			std::vector<std::uint8_t> m_overlay{};
+			// Start and finish as they're currently drawn
+			pathfinding::TileId m_shownStart{ pathfinding::invalidTile };
+			pathfinding::TileId m_shownFinish{ pathfinding::invalidTile };
+			bool m_pathShown{};
+			sf::RectangleShape m_hoverTile{};
 
 			// Pathfinding
-
-			// Path to finish
-			std::vector <sf::Vector2i> m_path{};
-			// All checked tiles
-			std::vector <sf::Vector2i> m_checkedTiles{};
-			// An array of animated checked tiles
-			std::vector<sf::Vector2i> m_checkedTilesAnimation{};
+			pathfinding::Pathfinder m_pathfinder{};
+
+			// Path to finish, checked tiles are moved into the trace as they arrive
+			pathfinding::SearchResult m_result{};
+			// Checked tiles of the current search, encoded
+			pathfinding::SearchTrace m_trace{};
+			// Trace file being replayed, shown instead of m_trace while it's open
+			pathfinding::MappedTrace m_replay{};
+			std::vector<pathfinding::TileId> m_published{};
+			// Checked tiles revealed so far, the cursor sits on the next one
+			std::size_t m_revealed{};
+			pathfinding::TraceCursor m_cursor{};
+			// Set by seeking on the timeline, holds the animation where it is
+			bool m_paused{};
+			// Tiles the animation owes, a fraction carries over to the next frame
+			double m_revealBudget{};
+			// Replan after every edit, set while the incremental method is running
+			bool m_livePlanning{};
+			// An edit came in while replanning, search again once the worker is done
+			bool m_replanPending{};
+
+			// Every stroke and bulk edit of the map, as snapshots sharing unchanged chunks
+			pathfinding::MapHistory m_history{};
+			// Edited tiles found after stepping through the history
+			std::vector<pathfinding::TileId> m_changedTiles{};
+
+			// Searches run on a worker thread, which only reads the pathfinder and its own copy
+			// of the map. The copy is brought up to the latest snapshot before each search by
+			// writing the chunks that changed, so the map can be edited while the worker runs.
+			pathfinding::Map m_searchMap;
+			std::shared_ptr<const pathfinding::MapSnapshot> m_searched{};
+			std::thread m_worker{};
+			pathfinding::SearchControl m_control{};
+			std::atomic<bool> m_workerDone{};
+			// Written by the worker, swapped into m_result once it's done
+			pathfinding::SearchResult m_workerResult{};
+			bool m_searching{};
+			// Show the result at once instead of animating it
+			bool m_skipAnimation{};
+			PathfindingMethod m_method{};
+			// Stats of every finished search since the start, kept for export
+			std::vector<pathfinding::SearchRecord> m_statsHistory{};
 
 			// Events
 			
@@ -82,22 +178,57 @@ namespace engine {
 			bool m_draggingFinish{};
 
 			// Member functions
-			void create(int rows, int columns);
+			void setMap(pathfinding::Map map);
 			bool isMouseOverGrid() const;
-			sf::Vector2i getTileUnderMouse() const;
+			pathfinding::Position getTileUnderMouse() const;
+			// Cost the brush in the ui paints, 0 for obstacles
+			std::uint8_t brushCost() const;
 			sf::Vector2f getTilePosition(int row, int col) const;
-
-			void drawPath(sf::RectangleShape& tile);
-			
-			// Breadth first search
-			bool isVisited(sf::Vector2i& tile, std::vector<std::vector<bool>>& visited);
-			bool isValidTile(sf::Vector2i& tile);
-			std::vector<sf::Vector2i> breadthFirstSearch();
-			
-			// A*
-			bool isVisited(sf::Vector2i& tile, std::unordered_map<int, std::unordered_map<int, std::shared_ptr<Tile>>>& visited);
-			double heuristic(sf::Vector2i curPos, sf::Vector2i endPos);
-			std::vector<sf::Vector2i> aStarSearch();
+			sf::Vector2f getTilePosition(pathfinding::TileId tile) const;
+
+			// Camera
+			void resetCamera();
+			void clampCamera();
+			// On screen size of one tile, in pixels
+			float tilePixels() const;
+			bool isDetailed() const { return tilePixels() >= settings::detailTilePixels; }
+
+			// Vertex array and textures
+			sf::IntRect visibleTiles() const;
+			// Forget everything drawn, after the map changed as a whole
+			void resetTiles();
+			// Redraw every tile from the map, keeping the overlay
+			void redrawTiles();
+			// Redraw the tiles edited since the given map revision
+			void showEdits(std::uint64_t revision);
+			void stepHistory(bool back);
+			void buildTiles(const sf::IntRect& visible);
+			void uploadTiles();
+			void buildPages();
+			void markDirtyPages();
+			void uploadPages();
+			void drawPages(const sf::IntRect& visible);
+			void refreshTile(pathfinding::TileId tile);
+			void setOverlay(pathfinding::TileId tile, TileOverlay overlay, bool shown);
+			// Return every checked and path tile to its map colour
+			void clearOverlay();
+			sf::Color tileColor(pathfinding::TileId tile) const;
+			// Gap between tiles, dropped when tiles get too small for it
+			float tileGap() const;
+
+			pathfinding::TraceView traceView() const;
+			void animatePath();
+			// Reveal or hide checked tiles until the first step tiles are shown
+			void revealTo(std::size_t step);
+			void hidePath();
+			void drawHover();
+			void replan();
+
+			void startSearch(PathfindingMethod method);
+			// Cancel the running search and wait for the worker, takes at most a chunk of expansions
+			void stopSearch();
+			// Pick up published checked tiles and the finished result
+			void collectSearch();
 		};
 
 		extern Grid grid;
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "map.h"
+#include "control.h"
+#include "stamps.h"
+#include "open_list.h"
+#include "landmarks.h"
+#include "neighbourhood.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		/*
+			A* with a Manhattan heuristic, or an octile one when diagonal moves are allowed.
+			Costs, parents and open/closed state live in flat arrays indexed by TileId and
+			are reused between queries, so an expansion never allocates once the buffers
+			have grown to the map size.
+
+			With a landmark table the heuristic is the larger of Manhattan distance and
+			the ALT bound, the table must be synced with the map first. Landmark distances
+			are four connected, so that search always is too.
+
+			The open list is a template parameter, see open_list.h. Lists with
+			decrease-key get improved tiles moved up in place instead of pushed again.
+		*/
+		template <typename OpenList>
+		class BasicAStarEngine {
+		public:
+			void search(const Map& map, Position startTile, Position finishTile, SearchResult& result, SearchControl* control = nullptr, Movement movement = Movement::FourConnected);
+			void search(const Map& map, Position startTile, Position finishTile, const LandmarkTable& landmarks, SearchResult& result, SearchControl* control = nullptr);
+
+			std::size_t memoryUsage() const { return m_state.memoryUsage() + capacityBytes(m_gCost) + capacityBytes(m_parent) + m_open.memoryUsage(); }
+
+		private:
+			TileStamps m_state{};
+			std::vector<std::uint32_t> m_gCost{};
+			std::vector<TileId> m_parent{};
+			OpenList m_open{};
+
+			// Distance is a policy from neighbourhood.h
+			template <typename Neighbourhood, typename Distance>
+			void search(const Map& map, TileId start, TileId finish, SearchResult& result, SearchControl* control);
+
+			// heuristic(tile, row, column) in padded coordinates
+			template <typename Neighbourhood, typename Heuristic>
+			void search(const Map& map, TileId start, TileId finish, SearchResult& result, SearchControl* control, const Heuristic& heuristic);
+		};
+
+		// Instantiated in astar.cpp
+		extern template class BasicAStarEngine<BinaryHeapOpenList>;
+		extern template class BasicAStarEngine<QuaternaryHeapOpenList>;
+		extern template class BasicAStarEngine<PairingHeapOpenList>;
+		extern template class BasicAStarEngine<BucketOpenList>;
+
+		using AStarEngine = BasicAStarEngine<BinaryHeapOpenList>;
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "pathfinder.h"
+#include "thread_pool.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		struct PathQuery
+		{
+			Position start{};
+			Position finish{};
+			PathfindingMethod method{ AStar };
+		};
+
+		/*
+			Answers many queries on one map in parallel. Every worker reads the same map,
+			which must not change during solve, and keeps its own Pathfinder, so engine
+			buffers and cached preprocessing are reused between batches and only refreshed
+			when the map revision changes. Parallel breadth first queries run on their
+			worker's thread alone, the batch is what's spread over the threads.
+		*/
+		class BatchSolver {
+		public:
+			// 0 uses one thread per hardware thread
+			explicit BatchSolver(std::size_t threads = 0);
+
+			std::size_t threads() const { return m_pool.size(); }
+
+			// Passed on to every worker's Pathfinder
+			void setLandmarkCount(std::size_t count);
+			void setOpenList(OpenListKind kind);
+
+			// results[i] answers queries[i], queries outside the map aren't found
+			void solve(const Map& map, const std::vector<PathQuery>& queries, std::vector<SearchResult>& results);
+
+		private:
+			struct Worker
+			{
+				Pathfinder pathfinder{};
+			};
+
+			ThreadPool m_pool;
+			std::vector<std::unique_ptr<Worker>> m_workers{};
+		};
+	}
+}
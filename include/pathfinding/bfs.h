@@ -0,0 +1,22 @@
+#pragma once
+
+#include "map.h"
+#include "control.h"
+#include "stamps.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		// Breadth first search, keeps its buffers between queries
+		class BreadthFirstEngine {
+		public:
+			void search(const Map& map, Position startTile, Position finishTile, SearchResult& result, SearchControl* control = nullptr);
+			std::size_t memoryUsage() const { return m_visited.memoryUsage() + capacityBytes(m_parent) + capacityBytes(m_queue); }
+
+		private:
+			TileStamps m_visited{};
+			std::vector<TileId> m_parent{};
+			std::vector<TileId> m_queue{};
+		};
+	}
+}
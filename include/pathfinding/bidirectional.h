@@ -0,0 +1,62 @@
+#pragma once
+
+#include "map.h"
+#include "control.h"
+#include "stamps.h"
+#include "open_list.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		/*
+			Breadth first search growing one frontier from the start and one from the
+			finish. The smaller frontier expands a whole level at a time, and the search
+			stops after the level in which the frontiers first touch.
+		*/
+		class BidirectionalBreadthFirstEngine {
+		public:
+			void search(const Map& map, Position startTile, Position finishTile, SearchResult& result, SearchControl* control = nullptr);
+			std::size_t memoryUsage() const;
+
+		private:
+			struct Side
+			{
+				TileStamps seen{};
+				std::vector<std::uint32_t> distance{};
+				std::vector<TileId> parent{};
+				std::vector<TileId> queue{};
+				// First tile of the level that will be expanded next
+				std::size_t head{};
+			};
+
+			Side m_forward{};
+			Side m_backward{};
+		};
+
+		/*
+			A* from both ends at once, each side aiming at the other's origin. The side
+			with the smaller open list expands next, and the search stops once either
+			side's best f reaches the cheapest connection found so far.
+		*/
+		class BidirectionalAStarEngine {
+		public:
+			void search(const Map& map, Position startTile, Position finishTile, SearchResult& result, SearchControl* control = nullptr);
+			std::size_t memoryUsage() const;
+
+		private:
+			struct Side
+			{
+				TileStamps state{};
+				std::vector<std::uint32_t> gCost{};
+				std::vector<TileId> parent{};
+				BinaryHeapOpenList open{};
+				// Padded coordinates of the tile this side is heading for
+				int targetRow{};
+				int targetColumn{};
+			};
+
+			Side m_forward{};
+			Side m_backward{};
+		};
+	}
+}
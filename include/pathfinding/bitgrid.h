@@ -0,0 +1,70 @@
+#pragma once
+
+#include "map.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace engine {
+	namespace pathfinding {
+
+		inline int countTrailingZeros(std::uint64_t value)
+		{
+#ifdef _MSC_VER
+			unsigned long index{};
+			_BitScanForward64(&index, value);
+			return static_cast<int>(index);
+#else
+			return __builtin_ctzll(value);
+#endif
+		}
+
+		inline int countLeadingZeros(std::uint64_t value)
+		{
+#ifdef _MSC_VER
+			unsigned long index{};
+			_BitScanReverse64(&index, value);
+			return 63 - static_cast<int>(index);
+#else
+			return __builtin_clzll(value);
+#endif
+		}
+
+		/*
+			The walkable plane of a map packed one bit per tile, in TileId order. Since the
+			map is padded, a row's neighbours are plain bit offsets and the whole grid can be
+			treated as one long bit string. Spare words before and after the map let
+			window() read 64 bits around any tile without bounds checks.
+		*/
+		class BitGrid {
+		public:
+			void build(const Map& map);
+
+			bool test(TileId tile) const { return (m_words[wordIndex(tile)] >> bitIndex(tile)) & 1; }
+			void set(TileId tile, bool value);
+
+			// 64 tiles starting at the given tile, which may lie up to padding tiles outside the map
+			std::uint64_t window(std::int64_t tile) const
+			{
+				std::uint64_t position = static_cast<std::uint64_t>(tile + padding);
+				std::size_t word = position >> 6;
+				unsigned shift = position & 63;
+
+				if (shift == 0) return m_words[word];
+				return (m_words[word] >> shift) | (m_words[word + 1] << (64 - shift));
+			}
+
+			std::size_t memoryUsage() const { return m_words.capacity() * sizeof(std::uint64_t); }
+
+			// Tiles of spare space on each side of the map
+			static constexpr std::int64_t padding{ 128 };
+
+		private:
+			std::vector<std::uint64_t> m_words{};
+
+			static std::size_t wordIndex(TileId tile) { return (tile + padding) >> 6; }
+			static unsigned bitIndex(TileId tile) { return (tile + padding) & 63; }
+		};
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "chunked_map.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		// Like SearchResult, with positions since a chunked map's tiles don't fit a TileId
+		struct ChunkedSearchResult
+		{
+			// Path to finish, without the start and finish tiles
+			std::vector<Position> path{};
+			// Total cost of the path, one per step
+			double cost{};
+			bool found{};
+			SearchStats stats{};
+
+			// Empty the result but keep its buffers for the next query
+			void clear()
+			{
+				path.clear();
+				cost = 0;
+				found = false;
+				stats = {};
+			}
+		};
+
+		/*
+			Four connected A* with a Manhattan heuristic over a ChunkedMap, counting steps
+			like AStarEngine. Search state is kept per chunk and only for the chunks the
+			search reaches, so its memory follows the explored area rather than the map.
+			Parents are stored as the direction back, one byte per tile.
+		*/
+		class ChunkedAStarEngine {
+		public:
+			void search(ChunkedMap& map, Position start, Position finish, ChunkedSearchResult& result);
+
+			std::size_t memoryUsage() const;
+
+		private:
+			struct Block
+			{
+				std::uint32_t gCost[ChunkedMap::chunkBytes];
+				// Direction to the parent in the low bits, seen and closed flags above
+				std::uint8_t state[ChunkedMap::chunkBytes];
+			};
+
+			struct Node
+			{
+				// f and h packed like OpenNode::key()
+				std::uint64_t key{};
+				Position tile{};
+			};
+
+			// Search state of the chunks reached by the current query
+			std::vector<std::unique_ptr<Block>> m_blocks{};
+			std::size_t m_usedBlocks{};
+			std::unordered_map<std::uint64_t, Block*> m_blockOf{};
+			// Neighbours are mostly in the same chunk, the last block skips the lookup
+			std::uint64_t m_lastIndex{};
+			Block* m_lastBlock{};
+			std::vector<Node> m_open{};
+
+			Block& block(Position tile);
+		};
+	}
+}
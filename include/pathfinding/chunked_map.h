@@ -0,0 +1,131 @@
+#pragma once
+
+#include "map.h"
+#include "mapped_file.h"
+
+#include <cstdio>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace engine {
+	namespace pathfinding {
+
+		/*
+			Maps too large for memory, stored on disk in chunkSize x chunkSize chunks and
+			mapped with MappedFile. Opening only reads the header, so it takes the same
+			time for any map size. A chunk is read from disk when a search or the
+			renderer first touches it, and at most budget chunks stay resident, the least
+			recently used ones are dropped first. Tiles hold costs as in Map, 0 is an
+			obstacle and everything outside the map reads as one.
+
+			File layout: a page holding the header, the stored chunks (chunkBytes each, so
+			every one is page aligned), then one ChunkEntry per chunk in row-major chunk
+			order. Chunks whose tiles are all the same aren't stored, their entry holds the
+			value instead. Native byte order, like trace files.
+
+			Not thread safe, every thread needs its own ChunkedMap.
+		*/
+		class ChunkedMap {
+		public:
+			static constexpr int chunkShift{ 6 };
+			static constexpr int chunkSize{ 1 << chunkShift };
+			static constexpr std::size_t chunkBytes{ chunkSize * chunkSize };
+			static constexpr int maxDimension{ 1 << 30 };
+
+			struct ChunkEntry
+			{
+				// Byte offset of the chunk's tiles, 0 when it isn't stored
+				std::uint64_t offset{};
+				// Value of every tile of a chunk that isn't stored
+				std::uint8_t fill{};
+				std::uint8_t reserved[7]{};
+			};
+
+			// Returns false if the file can't be mapped or isn't a chunked map
+			bool open(const std::string& path);
+			void close();
+			bool isOpen() const { return m_file.isOpen(); }
+
+			int rows() const { return m_rows; }
+			int columns() const { return m_columns; }
+			bool isInside(Position tile) const { return tile.row >= 0 && tile.column >= 0 && tile.row < m_rows && tile.column < m_columns; }
+
+			// Tiles of a chunk row-major, reads as obstacles outside the map or for a corrupt entry
+			const std::uint8_t* chunk(int chunkRow, int chunkColumn);
+
+			std::uint8_t cost(Position tile)
+			{
+				if (!isInside(tile)) return 0;
+				return chunk(tile.row >> chunkShift, tile.column >> chunkShift)[(tile.row & (chunkSize - 1)) * chunkSize + (tile.column & (chunkSize - 1))];
+			}
+
+			bool isWalkable(Position tile) { return cost(tile) != 0; }
+
+			// Most stored chunks kept in memory, at least one
+			void setChunkBudget(std::size_t chunks);
+			std::size_t chunkBudget() const { return m_budget; }
+			std::size_t residentChunks() const { return m_resident.size(); }
+
+			// Copy the tiles from corner onwards into a dense map, as much of it as the map covers
+			void extract(Position corner, Map& map);
+
+		private:
+			MappedFile m_file{};
+			int m_rows{};
+			int m_columns{};
+			int m_chunkRows{};
+			int m_chunkColumns{};
+			const ChunkEntry* m_entries{};
+
+			// Stored chunks in memory, most recently used first
+			std::size_t m_budget{ 4096 };
+			std::list<std::uint64_t> m_recent{};
+			std::unordered_map<std::uint64_t, std::list<std::uint64_t>::iterator> m_resident{};
+
+			// Searches mostly stay inside one chunk, so the last one skips the lookup
+			std::uint64_t m_lastChunk{ ~std::uint64_t{} };
+			const std::uint8_t* m_lastTiles{};
+
+			// One chunk per fill value, created when a chunk first needs it
+			std::unique_ptr<std::uint8_t[]> m_uniform[256]{};
+
+			const std::uint8_t* uniform(std::uint8_t fill);
+			void touch(std::uint64_t index);
+			// Drop least recently used chunks until the budget holds
+			void trim();
+		};
+
+		/*
+			Writes a chunked map one band of chunkSize rows at a time, so the source never
+			has to be in memory as a whole. Only the chunk index grows with the map.
+		*/
+		class ChunkedMapWriter {
+		public:
+			ChunkedMapWriter() = default;
+			ChunkedMapWriter(const ChunkedMapWriter&) = delete;
+			ChunkedMapWriter& operator=(const ChunkedMapWriter&) = delete;
+			~ChunkedMapWriter();
+
+			bool open(const std::string& path, int rows, int columns);
+			// The next chunkSize rows, fewer for the last band, row-major and columns() wide
+			bool writeBand(const std::uint8_t* tiles, int bandRows);
+			// Writes the chunk index and header, false if anything failed or rows are missing
+			bool close();
+
+		private:
+			std::FILE* m_file{};
+			int m_rows{};
+			int m_columns{};
+			int m_written{};
+			std::uint64_t m_offset{};
+			bool m_failed{};
+			std::vector<ChunkedMap::ChunkEntry> m_entries{};
+			std::vector<std::uint8_t> m_chunk{};
+		};
+
+		// Converts a dense map, returns false if the file can't be written
+		bool writeChunkedMap(const std::string& path, const Map& map);
+	}
+}
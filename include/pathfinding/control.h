@@ -0,0 +1,58 @@
+#pragma once
+
+#include "types.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace engine {
+	namespace pathfinding {
+
+		/*
+			Lets another thread stop a running search and watch its progress. The engine
+			calls keepSearching() once per expanded tile and hands over its new checked
+			tiles in chunks, so the reader never touches the engine's own vectors.
+		*/
+		class SearchControl {
+		public:
+			// Number of checked tiles collected before they're handed over
+			static constexpr std::size_t publishInterval{ 1024 };
+
+			// Call before starting a search
+			void reset();
+			void cancel() { m_cancelled.store(true, std::memory_order_relaxed); }
+			bool cancelled() const { return m_cancelled.load(std::memory_order_relaxed); }
+
+			// A reader that only wants the final result turns publishing off, which drops
+			// anything published but not taken yet. Call reset() to turn it back on.
+			void setPublishing(bool publishing);
+
+			// Engine side, returns false when the search should stop
+			bool keepSearching(const std::vector<TileId>& checked)
+			{
+				if (checked.size() - m_published >= publishInterval && m_publishing.load(std::memory_order_relaxed)) publish(checked);
+
+				return !cancelled();
+			}
+
+			// Reader side, appends the tiles published since the last call
+			void take(std::vector<TileId>& tiles);
+
+		private:
+			std::atomic<bool> m_cancelled{};
+			std::atomic<bool> m_publishing{ true };
+			std::mutex m_mutex{};
+			std::vector<TileId> m_pending{};
+			// Owned by the engine thread
+			std::size_t m_published{};
+
+			void publish(const std::vector<TileId>& checked);
+		};
+
+		// Shorthand for engines, which take an optional control
+		inline bool keepSearching(SearchControl* control, const std::vector<TileId>& checked)
+		{
+			return !control || control->keepSearching(checked);
+		}
+	}
+}
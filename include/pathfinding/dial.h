@@ -0,0 +1,33 @@
+#pragma once
+
+#include "map.h"
+#include "control.h"
+#include "stamps.h"
+#include "open_list.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		/*
+			A* over terrain costs, the only engine that reads them. Stepping onto a tile
+			costs its value in the map, and every step costs at least 1, so Manhattan
+			distance stays a consistent heuristic. f only grows by up to maxCost + 1 per
+			step, which lets a ring of buckets replace the heap (Dial's algorithm).
+
+			On maps without terrain it finds the same paths as A*.
+		*/
+		class DialEngine {
+		public:
+			void search(const Map& map, Position startTile, Position finishTile, SearchResult& result, SearchControl* control = nullptr);
+
+			std::size_t memoryUsage() const { return m_state.memoryUsage() + capacityBytes(m_gCost) + capacityBytes(m_parent) + m_open.memoryUsage(); }
+
+		private:
+			TileStamps m_state{};
+			// 64 bits, a path across the largest map at the highest cost passes 2^32
+			std::vector<std::uint64_t> m_gCost{};
+			std::vector<TileId> m_parent{};
+			BucketOpenList m_open{ Map::maxCost + 1 };
+		};
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "map.h"
+#include "control.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		/*
+			D* Lite. Searches backwards from the finish and keeps its state between
+			queries, so moving the start or editing a few tiles only repairs the part
+			of the search tree that changed. Moving the finish, resizing or a bulk
+			edit starts over. Checked tiles are the ones the last repair touched.
+		*/
+		class DStarLiteEngine {
+		public:
+			void search(const Map& map, Position startTile, Position finishTile, SearchResult& result, SearchControl* control = nullptr);
+
+			std::size_t memoryUsage() const
+			{
+				return capacityBytes(m_g) + capacityBytes(m_rhs) + capacityBytes(m_queuedKey) + m_inQueue.capacity() / 8 + capacityBytes(m_queue) + capacityBytes(m_changed);
+			}
+
+		private:
+			struct Key
+			{
+				std::uint32_t first{};
+				std::uint32_t second{};
+
+				bool operator<(const Key& other) const { return first < other.first || (first == other.first && second < other.second); }
+				bool operator==(const Key& other) const { return first == other.first && second == other.second; }
+			};
+
+			struct QueueEntry
+			{
+				Key key{};
+				TileId tile{};
+			};
+
+			// Distance to the finish and its one step lookahead
+			std::vector<std::uint32_t> m_g{};
+			std::vector<std::uint32_t> m_rhs{};
+			// Key each tile is queued with, entries with a different key are stale
+			std::vector<Key> m_queuedKey{};
+			std::vector<bool> m_inQueue{};
+			std::vector<QueueEntry> m_queue{};
+
+			std::uint64_t m_revision{};
+			std::vector<TileId> m_changed{};
+			std::size_t m_size{};
+			TileId m_finish{ invalidTile };
+			TileId m_lastStart{};
+			std::uint32_t m_keyModifier{};
+			// Counted by push and top, which don't see the result
+			SearchStats m_stats{};
+
+			// Current query
+			const std::uint8_t* m_cells{};
+			std::array<std::ptrdiff_t, 4> m_offsets{};
+			int m_stride{};
+			TileId m_start{};
+
+			void initialize(const Map& map, TileId start, TileId finish);
+			void sync(const Map& map, TileId start, TileId finish);
+
+			std::uint32_t heuristic(TileId a, TileId b) const;
+			std::uint32_t cost(TileId a, TileId b) const { return (m_cells[a] || a == m_start) && m_cells[b] ? 1 : infinity; }
+			Key calculateKey(TileId tile) const;
+			std::uint32_t lookahead(TileId tile) const;
+
+			void updateVertex(TileId tile);
+			void push(TileId tile, Key key);
+			void pop();
+			// Drops stale entries, returns false when the queue is empty
+			bool top(QueueEntry& entry);
+			// Returns false when cancelled, the state stays valid and the next query resumes
+			bool computeShortestPath(SearchResult& result, SearchControl* control);
+
+			static constexpr std::uint32_t infinity{ ~std::uint32_t{} / 2 };
+		};
+	}
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "map.h"
+#include "control.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		/*
+			Breadth first search on bitboards. The walkable plane, the visited set and the
+			frontier are packed one bit per tile in TileId order, so one ring of the flood
+			is four shifts of the frontier (one tile sideways, one stride up or down) masked
+			with walkable & ~visited, 64 tiles per word or 256 per AVX2 register.
+
+			Only the words a frontier tile can step into are touched, found through a bitmap
+			with one bit per word, so narrow fronts in mazes don't pay for the whole map
+			every ring. The words each ring reached are kept, the path is walked back
+			through them one ring at a time and the next query clears just those words.
+			Per tile distances are only written by fill().
+		*/
+		class FloodFillEngine {
+		public:
+			void search(const Map& map, Position startTile, Position finishTile, SearchResult& result, SearchControl* control = nullptr);
+
+			std::size_t memoryUsage() const
+			{
+				return capacityBytes(m_walkable) + capacityBytes(m_visited) + capacityBytes(m_frontier) + capacityBytes(m_next) + capacityBytes(m_changed)
+					+ capacityBytes(m_distance) + capacityBytes(m_ringWords) + capacityBytes(m_ringBits) + capacityBytes(m_ringStarts) + capacityBytes(m_marks)
+					+ capacityBytes(m_markedWords);
+			}
+
+			// Distance field over everything reachable from source, read with distance()
+			void fill(const Map& map, TileId source);
+			// Steps from the source of the last fill, unreachable for tiles it didn't reach. A search
+			// since then leaves it undefined.
+			std::uint32_t distance(TileId tile) const { return isVisited(tile) ? m_distance[tile] : unreachable; }
+
+			static constexpr std::uint32_t unreachable{ ~std::uint32_t{} };
+
+		private:
+			struct Span
+			{
+				std::size_t begin{};
+				std::size_t end{};
+			};
+
+			// Word arrays start margin words before tile 0 so shifted reads never leave them
+			std::vector<std::uint64_t> m_walkable{};
+			std::vector<std::uint64_t> m_visited{};
+			std::vector<std::uint64_t> m_frontier{};
+			std::vector<std::uint64_t> m_next{};
+			std::size_t m_margin{};
+			std::size_t m_mapWords{};
+			std::size_t m_size{};
+			int m_stride{};
+
+			std::uint64_t m_revision{};
+			std::vector<TileId> m_changed{};
+
+			std::vector<std::uint32_t> m_distance{};
+			// Words each ring reached and their new bits in word order, ring r is
+			// [m_ringStarts[r], m_ringStarts[r + 1]) and ring 0 is the source
+			std::vector<std::size_t> m_ringWords{};
+			std::vector<std::uint64_t> m_ringBits{};
+			std::vector<std::size_t> m_ringStarts{};
+			// One bit per word marking the words to grow next, and one bit per word of marks
+			// that has any, so rings a few tiles wide don't scan marks for the whole map
+			std::vector<std::uint64_t> m_marks{};
+			std::vector<std::uint64_t> m_markedWords{};
+
+			std::size_t wordIndex(TileId tile) const { return (tile >> 6) + m_margin; }
+			bool isVisited(TileId tile) const { return tile < m_size && (m_visited[wordIndex(tile)] >> (tile & 63)) & 1; }
+
+			void sync(const Map& map);
+			// Floods from source until target is reached, returns whether it was. Tiles are
+			// only listed in checked, or given their distance, when asked for.
+			bool flood(TileId source, TileId target, std::vector<TileId>* checked, bool distances, SearchStats* stats, SearchControl* control);
+			// Tiles of one word the current frontier reaches that weren't visited yet
+			std::uint64_t reach(std::size_t word) const;
+			// m_next over one span of words from the current frontier
+			void grow(Span span);
+			// Records the tiles a word reached in the current ring
+			void collect(std::size_t word, std::uint64_t reached, std::uint32_t ring, TileId target, std::vector<TileId>* checked, bool distances, bool& found);
+			// Whether ring reached tile
+			bool inRing(std::uint32_t ring, TileId tile) const;
+		};
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "map.h"
+#include "control.h"
+#include "stamps.h"
+#include "open_list.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		/*
+			Hierarchical pathfinding (HPA*). The map is cut into square clusters, and
+			open stretches along each cluster border get one or two entrances. Distances
+			between the entrances of a cluster are precomputed. A query links the start
+			and finish to the entrances of their clusters, runs A* over that small
+			abstract graph, and refines each abstract edge back into tiles.
+
+			Paths are close to, but not always exactly, the shortest. Edits reported by
+			the map's change history only rebuild the clusters they touch, plus a
+			neighbour when the edit is on a shared border.
+		*/
+		class HierarchicalEngine {
+		public:
+			static constexpr int clusterSize{ 16 };
+
+			void search(const Map& map, Position startTile, Position finishTile, SearchResult& result, SearchControl* control = nullptr);
+			std::size_t memoryUsage() const;
+
+		private:
+			struct Cluster
+			{
+				// Entrance tiles, a tile on two borders appears once per crossing
+				std::vector<TileId> entrances{};
+				// Tile across the border each entrance leads to
+				std::vector<TileId> partners{};
+				// Shortest distance inside the cluster between every pair of entrances
+				std::vector<std::uint32_t> distances{};
+			};
+
+			std::vector<Cluster> m_clusters{};
+			std::vector<std::size_t> m_dirty{};
+			std::vector<bool> m_isDirty{};
+			int m_clusterRows{};
+			int m_clusterColumns{};
+			int m_rows{};
+			int m_columns{};
+			std::uint64_t m_revision{};
+			std::vector<TileId> m_changed{};
+
+			// Abstract search
+			TileStamps m_state{};
+			std::vector<std::uint32_t> m_gCost{};
+			std::vector<TileId> m_parent{};
+			BinaryHeapOpenList m_open{};
+			std::vector<TileId> m_abstractPath{};
+			std::uint64_t m_pushed{};
+			// Goal of the current query, for the heuristic
+			Position m_finishTile{};
+
+			// Breadth first search inside one cluster, indexed by local row * clusterSize + local column
+			std::vector<std::uint32_t> m_localDistance{};
+			std::vector<std::uint16_t> m_localParent{};
+			std::vector<std::uint16_t> m_localQueue{};
+			std::vector<std::uint32_t> m_startDistance{};
+			std::vector<std::uint32_t> m_finishDistance{};
+
+			// Returns false when cancelled, unfinished clusters stay dirty
+			bool sync(const Map& map, SearchControl* control);
+			void markDirty(std::size_t cluster);
+			void rebuild(const Map& map, std::size_t cluster);
+			void addBorder(const Map& map, Cluster& cluster, Position first, Position step, Position across, int length);
+
+			std::size_t clusterOf(Position tile) const { return static_cast<std::size_t>(tile.row / clusterSize) * m_clusterColumns + tile.column / clusterSize; }
+			Position clusterOrigin(std::size_t cluster) const;
+			std::size_t localIndex(const Map& map, std::size_t cluster, TileId tile) const;
+			void localSearch(const Map& map, std::size_t cluster, TileId source);
+
+			void expand(const Map& map, TileId tile, TileId start, TileId finish, std::size_t finishCluster);
+			void relax(const Map& map, TileId from, TileId to, std::uint32_t distance);
+			void refine(const Map& map, TileId start, TileId finish, std::vector<TileId>& path);
+		};
+	}
+}
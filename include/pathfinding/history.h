@@ -0,0 +1,125 @@
+#pragma once
+
+#include "map.h"
+
+#include <deque>
+#include <memory>
+
+namespace engine {
+	namespace pathfinding {
+
+		/*
+			A map's tiles at one point in time, cut into chunkSize x chunkSize chunks that
+			are shared between snapshots by reference count, so a snapshot only owns the
+			chunks that changed since the one it was made from. A chunk is never written
+			once a snapshot holds it, which makes any snapshot safe to read from another
+			thread while the map it was taken from keeps being edited.
+
+			Tiles past the edge of the map in the last row and column of chunks are 0.
+		*/
+		class MapSnapshot {
+		public:
+			// Same chunks as ChunkedMap
+			static constexpr int chunkShift{ 6 };
+			static constexpr int chunkSize{ 1 << chunkShift };
+			static constexpr std::size_t chunkBytes{ chunkSize * chunkSize };
+
+			using Chunk = std::array<std::uint8_t, chunkBytes>;
+
+			int rows() const { return m_rows; }
+			int columns() const { return m_columns; }
+			Position start() const { return m_start; }
+			Position finish() const { return m_finish; }
+			std::size_t chunkCount() const { return m_chunks.size(); }
+
+			std::uint8_t cost(Position tile) const
+			{
+				assert(tile.row >= 0 && tile.column >= 0 && tile.row < m_rows && tile.column < m_columns);
+
+				const Chunk& chunk = *m_chunks[static_cast<std::size_t>(tile.row >> chunkShift) * m_chunkColumns + (tile.column >> chunkShift)];
+				return chunk[(tile.row & (chunkSize - 1)) * chunkSize + (tile.column & (chunkSize - 1))];
+			}
+
+			// Write the given chunks and the start and finish into a map of the same size
+			void restore(Map& map, const std::vector<std::uint32_t>& chunks) const;
+			// Same for every chunk not shared with base, for a map that holds base
+			void restore(Map& map, const MapSnapshot& base) const;
+
+		private:
+			friend class MapHistory;
+
+			int m_rows{};
+			int m_columns{};
+			int m_chunkColumns{};
+			Position m_start{};
+			Position m_finish{};
+			std::vector<std::shared_ptr<const Chunk>> m_chunks{};
+		};
+
+		/*
+			Undo and redo for a Map. Each commit is one step, a brush stroke or a bulk edit,
+			and keeps a snapshot sharing every unchanged chunk with the step before it.
+			Single tile edits are found through Map::changesSince, so committing and stepping
+			back or forward take time in the chunks changed rather than in the map. A bulk
+			edit compares every chunk once, and only the ones that differ are copied.
+		*/
+		class MapHistory {
+		public:
+			static constexpr std::size_t defaultDepth{ 100 };
+
+			// Forget every step and start over from map
+			void reset(const Map& map);
+
+			// The map as it is now, without making its edits a step
+			std::shared_ptr<const MapSnapshot> snapshot(const Map& map);
+
+			// Make the edits since the last step a step, returns false if there were none
+			bool commit(const Map& map);
+
+			// Step back or forward, editing map only where the steps differ. Edits that
+			// weren't committed become a step first, which drops the steps to redo.
+			bool undo(Map& map);
+			bool redo(Map& map);
+			bool canUndo() const { return m_current > 0; }
+			bool canRedo() const { return m_current + 1 < m_steps.size(); }
+
+			// Most steps kept to undo, the oldest are forgotten first
+			void setDepth(std::size_t steps);
+			std::size_t depth() const { return m_depth; }
+
+		private:
+			struct Step
+			{
+				std::shared_ptr<MapSnapshot> snapshot{};
+				// Chunks that differ from the step before
+				std::vector<std::uint32_t> changed{};
+			};
+
+			std::deque<Step> m_steps{};
+			std::size_t m_current{};
+			std::size_t m_depth{ defaultDepth };
+
+			// The map as last seen, the same snapshot as the current step until the map is edited
+			std::shared_ptr<MapSnapshot> m_working{};
+			// Map revision the working snapshot holds
+			std::uint64_t m_revision{};
+			// Chunks replaced in the working snapshot since the current step, may repeat
+			std::vector<std::uint32_t> m_pending{};
+			// Last chunk made, runs of identical chunks share it
+			std::shared_ptr<const MapSnapshot::Chunk> m_lastChunk{};
+			MapSnapshot::Chunk m_buffer{};
+			std::vector<TileId> m_changed{};
+
+			// Bring the working snapshot up to date with the map
+			void update(const Map& map);
+			// Copy the working snapshot first if anyone else holds it
+			MapSnapshot& writable();
+			// Replace a chunk of the working snapshot if its tiles in the map differ
+			void refresh(const Map& map, std::uint32_t index);
+			const std::shared_ptr<const MapSnapshot::Chunk>& makeChunk();
+			void moveTo(std::size_t step, const std::vector<std::uint32_t>& chunks, Map& map);
+			// Forget the oldest steps past the depth
+			void trim();
+		};
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "map.h"
+#include "control.h"
+#include "stamps.h"
+#include "open_list.h"
+#include "bitgrid.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		/*
+			Jump Point Search for 4-connected grids. Paths are searched in a canonical
+			order where vertical moves may turn horizontal anywhere, but horizontal moves
+			only turn vertical at a forced neighbour (an opening next to a wall). Straight
+			runs are skipped in one jump, so only the turning points reach the open list.
+
+			Horizontal jumps scan 64 tiles at a time on a bit-packed copy of the map,
+			which is patched from the map's change history or rebuilt after bulk edits.
+		*/
+		class JumpPointEngine {
+		public:
+			void search(const Map& map, Position startTile, Position finishTile, SearchResult& result, SearchControl* control = nullptr);
+
+			std::size_t memoryUsage() const
+			{
+				return m_walkable.memoryUsage() + capacityBytes(m_changed) + m_state.memoryUsage() + capacityBytes(m_gCost) + capacityBytes(m_parent) + m_open.memoryUsage();
+			}
+
+		private:
+			BitGrid m_walkable{};
+			std::uint64_t m_revision{};
+			std::vector<TileId> m_changed{};
+
+			TileStamps m_state{};
+			std::vector<std::uint32_t> m_gCost{};
+			std::vector<TileId> m_parent{};
+			BinaryHeapOpenList m_open{};
+
+			// Current query
+			TileId m_finish{};
+			std::int64_t m_stride{};
+			int m_finishRow{};
+			int m_finishColumn{};
+			std::uint64_t m_pushed{};
+
+			TileId jumpHorizontal(TileId tile, int direction) const;
+			TileId jumpVertical(TileId tile, std::int64_t direction) const;
+			bool isForced(TileId tile, int horizontal, std::int64_t vertical) const;
+
+			void relax(TileId from, TileId to);
+			void fillPath(TileId start, std::vector<TileId>& path) const;
+		};
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "map.h"
+#include "control.h"
+#include "stamps.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		/*
+			Exact walking distances from a few landmark tiles to every tile, for the ALT
+			heuristic. By the triangle inequality |d(L, a) - d(L, b)| never overestimates
+			d(a, b), and behind walls it is far tighter than Manhattan distance.
+
+			Landmarks are picked by farthest point selection, each one as far as possible
+			from the ones before it, which puts them in the corners and dead ends of a
+			floor plan. Distances are 16 bit and stored per tile, so one lookup reads all
+			of a tile's landmarks from the same cache line. The table is rebuilt lazily
+			when the map revision changes.
+		*/
+		class LandmarkTable {
+		public:
+			// Distance stored for tiles a landmark can't reach, or reaches in 65535 steps or more
+			static constexpr std::uint16_t far{ 0xFFFF };
+
+			explicit LandmarkTable(std::size_t count = 8) : m_requested{ count } {}
+
+			// Takes effect on the next sync
+			void setCount(std::size_t count);
+			const std::vector<TileId>& landmarks() const { return m_landmarks; }
+
+			// Rebuild when the map changed, returns false when cancelled
+			bool sync(const Map& map, SearchControl* control = nullptr);
+
+			// One distance per landmark
+			const std::uint16_t* distances(TileId tile) const { return m_distance.data() + static_cast<std::size_t>(tile) * m_landmarks.size(); }
+
+			// Landmarks that can't see both tiles give no bound
+			std::uint32_t lowerBound(const std::uint16_t* a, const std::uint16_t* b) const
+			{
+				std::uint32_t bound{};
+
+				for (std::size_t i{}; i < m_landmarks.size(); i++) {
+					if (a[i] == far || b[i] == far) continue;
+					bound = std::max<std::uint32_t>(bound, a[i] > b[i] ? a[i] - b[i] : b[i] - a[i]);
+				}
+
+				return bound;
+			}
+
+			std::size_t memoryUsage() const { return m_distance.capacity() * sizeof(std::uint16_t); }
+
+		private:
+			std::size_t m_requested{};
+			std::vector<TileId> m_landmarks{};
+			std::vector<std::uint16_t> m_distance{};
+			std::uint64_t m_revision{};
+			bool m_built{};
+
+			// Build buffers
+			TileStamps m_visited{};
+			std::vector<TileId> m_queue{};
+			// Distance from each tile to its nearest landmark so far
+			std::vector<std::uint32_t> m_nearest{};
+
+			void build(const Map& map, SearchControl* control);
+			// Breadth first search from source, leaves the reached tiles in m_queue in distance order
+			bool walk(const Map& map, TileId source, std::size_t column, std::size_t columns, SearchControl* control);
+		};
+	}
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "types.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		/*
+			Tiles are stored row-major in one contiguous array with a one tile wide
+			obstacle border around the map, so a neighbour of any inner tile is always
+			a valid index and searches never need bounds checks.
+
+			Each tile holds the cost of stepping onto it,
+			1 to 255 for open tiles (1 is plain ground),
+			0 for obstacles.
+
+			Engines other than Dial only look at whether a tile is open and count steps.
+
+			Start and finish are kept as separate coordinates and are always open.
+		*/
+		class Map {
+		public:
+
+			static constexpr int maxDimension{ 16384 };
+
+			Map(int rows, int columns);
+
+			int rows() const { return m_rows; }
+			int columns() const { return m_columns; }
+
+			// Distance between vertically adjacent tiles
+			int stride() const { return m_stride; }
+			// Number of tiles including the border, every TileId is below this
+			std::size_t size() const { return m_cells.size(); }
+
+			TileId id(int row, int column) const { return static_cast<TileId>((row + 1) * m_stride + column + 1); }
+			TileId id(Position tile) const { return id(tile.row, tile.column); }
+			Position position(TileId tile) const { return { static_cast<int>(tile / m_stride) - 1, static_cast<int>(tile % m_stride) - 1 }; }
+
+			// Offsets to the left, right, upper and lower neighbours
+			std::array<std::ptrdiff_t, 4> neighbourOffsets() const { return { -1, 1, -m_stride, m_stride }; }
+
+			const std::uint8_t* cells() const { return m_cells.data(); }
+			bool isWalkable(TileId tile) const { return m_cells[tile] != 0; }
+			bool isInside(Position tile) const;
+			bool isValidTile(Position tile) const { return isInside(tile) && isWalkable(id(tile)); }
+
+			void setWalkable(Position tile, bool walkable);
+
+			static constexpr std::uint8_t maxCost{ 255 };
+			std::uint8_t cost(TileId tile) const { return m_cells[tile]; }
+			// 0 makes the tile an obstacle
+			void setCost(Position tile, std::uint8_t cost);
+			// Cost of walking a path (without start and finish) from the start and stepping onto the finish
+			std::uint64_t pathCost(const std::vector<TileId>& path) const;
+
+			Position start() const { return m_start; }
+			Position finish() const { return m_finish; }
+			TileId startId() const { return id(m_start); }
+			TileId finishId() const { return id(m_finish); }
+			void setStart(Position tile) { m_start = tile; }
+			void setFinish(Position tile) { m_finish = tile; }
+
+			// Bulk edits, start and finish tiles are kept open
+			void clear();
+			void fill();
+			void randomize(int maxCoverage);
+
+			// Changes on every edit and is unique across all maps, lets engines know when cached data is stale
+			std::uint64_t revision() const { return m_revision; }
+
+			/*
+				Tiles edited one at a time since the given revision, so engines with cached
+				data can repair only what changed. Returns false when the history doesn't
+				reach back that far or a bulk edit happened since, and a full rebuild is needed.
+			*/
+			bool changesSince(std::uint64_t revision, std::vector<TileId>& tiles) const;
+
+		private:
+			struct Change
+			{
+				// Revision the edit was made on
+				std::uint64_t revision{};
+				TileId tile{};
+			};
+
+			static constexpr std::size_t maxChanges{ 4096 };
+
+			std::vector<std::uint8_t> m_cells{};
+			Position m_start{};
+			Position m_finish{};
+			int m_rows{};
+			int m_columns{};
+			int m_stride{};
+			std::uint64_t m_revision{};
+			std::vector<Change> m_changes{};
+
+			void setAll(bool walkable);
+			void touch();
+		};
+	}
+}
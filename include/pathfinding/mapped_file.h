@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace engine {
+	namespace pathfinding {
+
+		// A whole file mapped read-only, its pages are only read from disk as they're first touched
+		class MappedFile {
+		public:
+			MappedFile() = default;
+			MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+			MappedFile& operator=(MappedFile&& other) noexcept;
+			~MappedFile() { close(); }
+
+			// Returns false if the file can't be opened or is empty
+			bool open(const std::string& path);
+			void close();
+			bool isOpen() const { return m_data != nullptr; }
+
+			const std::uint8_t* data() const { return m_data; }
+			std::size_t size() const { return m_size; }
+
+			// Drop the pages of a range from memory, they're read from the file again when next touched
+			void release(std::size_t offset, std::size_t size) const;
+
+		private:
+			const std::uint8_t* m_data{};
+			std::size_t m_size{};
+		};
+	}
+}
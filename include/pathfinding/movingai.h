@@ -0,0 +1,62 @@
+#pragma once
+
+#include "pathfinder.h"
+#include "chunked_map.h"
+
+#include <string>
+
+namespace engine {
+	namespace pathfinding {
+
+		/*
+			Loaders for the MovingAI benchmark formats (https://movingai.com/benchmarks/formats.html).
+			'.', 'G' and 'S' tiles are passable, '@', 'O', 'T' and 'W' are obstacles.
+		*/
+
+		struct Scenario
+		{
+			int bucket{};
+			std::string mapName{};
+			Position start{};
+			Position finish{};
+			// Octile length with diagonal moves that don't cut corners
+			double optimalLength{};
+		};
+
+		// Replaces map with the contents of a .map file, returns false if it can't be read
+		bool loadMovingAiMap(const std::string& path, Map& map);
+		bool loadMovingAiScenarios(const std::string& path, std::vector<Scenario>& scenarios);
+
+		// Streams a .map file into a chunked map file a band of rows at a time, so it works for maps larger than memory
+		bool convertMovingAiMap(const std::string& mapPath, const std::string& chunkedPath);
+
+		struct ScenarioOutcome
+		{
+			double length{};
+			// Length the result is checked against
+			double referenceLength{};
+			std::size_t expanded{};
+			double seconds{};
+			bool found{};
+			bool valid{};
+		};
+
+		struct ScenarioReport
+		{
+			std::vector<ScenarioOutcome> outcomes{};
+			std::size_t solved{};
+			std::size_t failed{};
+			double seconds{};
+		};
+
+		/*
+			Run every scenario against the chosen method. The file's reference lengths
+			assume octile movement without corner cutting, which methods moving that way
+			under the pathfinder's movement are checked against. Corner cutting rules can
+			only make paths shorter, so those must not be longer than the reference. Four
+			connected methods are checked against a breadth first search on the same query
+			instead, which gives their exact optimum.
+		*/
+		ScenarioReport runScenarios(Map& map, const std::vector<Scenario>& scenarios, PathfindingMethod method, Pathfinder& pathfinder);
+	}
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "types.h"
+
+#include <cmath>
+
+namespace engine {
+	namespace pathfinding {
+
+		/*
+			Compile-time neighbourhood and heuristic policies. An engine templated on them
+			gets its neighbour loop written out move by move, with the corner rule and the
+			step costs folded in as constants, so nothing is decided at run time inside the
+			expansion loop.
+
+			Costs are fixed point: a straight move costs straightCost and a diagonal one
+			diagonalCost, 239/169 is within 1e-5 of sqrt(2). Paths stay below 32 bits up
+			to about 18 million moves.
+		*/
+		enum class CornerRule {
+			// Diagonal moves only need the tile they land on open
+			Cut,
+			// One of the two tiles the move passes has to be open
+			NoSqueezing,
+			// Both tiles it passes have to be open, as in the MovingAI benchmarks
+			NoCutting
+		};
+
+		struct FourConnected
+		{
+			static constexpr bool diagonal{ false };
+			static constexpr std::uint32_t straightCost{ 1 };
+
+			// visit(next, rowStep, columnStep, stepCost) for every open neighbour
+			template <typename Visit>
+			static void forEach(const std::uint8_t* cells, TileId tile, int stride, Visit&& visit)
+			{
+				const TileId up = tile - stride;
+				const TileId down = tile + stride;
+
+				if (cells[tile - 1]) visit(tile - 1, 0, -1, straightCost);
+				if (cells[tile + 1]) visit(tile + 1, 0, 1, straightCost);
+				if (cells[up]) visit(up, -1, 0, straightCost);
+				if (cells[down]) visit(down, 1, 0, straightCost);
+			}
+		};
+
+		template <CornerRule Rule>
+		struct EightConnected
+		{
+			static constexpr bool diagonal{ true };
+			static constexpr std::uint32_t straightCost{ 169 };
+			static constexpr std::uint32_t diagonalCost{ 239 };
+
+			template <typename Visit>
+			static void forEach(const std::uint8_t* cells, TileId tile, int stride, Visit&& visit)
+			{
+				const TileId up = tile - stride;
+				const TileId down = tile + stride;
+				const bool left = cells[tile - 1] != 0;
+				const bool right = cells[tile + 1] != 0;
+				const bool above = cells[up] != 0;
+				const bool below = cells[down] != 0;
+
+				if (left) visit(tile - 1, 0, -1, straightCost);
+				if (right) visit(tile + 1, 0, 1, straightCost);
+				if (above) visit(up, -1, 0, straightCost);
+				if (below) visit(down, 1, 0, straightCost);
+
+				// The border keeps every diagonal inside the map too
+				if (passes(above, left) && cells[up - 1]) visit(up - 1, -1, -1, diagonalCost);
+				if (passes(above, right) && cells[up + 1]) visit(up + 1, -1, 1, diagonalCost);
+				if (passes(below, left) && cells[down - 1]) visit(down - 1, 1, -1, diagonalCost);
+				if (passes(below, right) && cells[down + 1]) visit(down + 1, 1, 1, diagonalCost);
+			}
+
+		private:
+			// Can a diagonal move go between these two orthogonal tiles
+			static constexpr bool passes(bool first, bool second)
+			{
+				if constexpr (Rule == CornerRule::Cut) return true;
+				else if constexpr (Rule == CornerRule::NoSqueezing) return first || second;
+				else return first && second;
+			}
+		};
+
+		// Exact on open ground, which makes it the Manhattan distance when moves are four connected
+		struct OctileDistance
+		{
+			template <typename Neighbourhood>
+			static std::uint32_t estimate(int rowDistance, int columnDistance)
+			{
+				int rows = std::abs(rowDistance);
+				int columns = std::abs(columnDistance);
+
+				if constexpr (!Neighbourhood::diagonal) return static_cast<std::uint32_t>(rows + columns) * Neighbourhood::straightCost;
+				else {
+					auto shorter = static_cast<std::uint32_t>(std::min(rows, columns));
+					auto longer = static_cast<std::uint32_t>(std::max(rows, columns));
+					return (longer - shorter) * Neighbourhood::straightCost + shorter * Neighbourhood::diagonalCost;
+				}
+			}
+		};
+
+		struct ManhattanDistance
+		{
+			template <typename Neighbourhood>
+			static std::uint32_t estimate(int rowDistance, int columnDistance)
+			{
+				static_assert(!Neighbourhood::diagonal, "Manhattan distance overestimates diagonal moves");
+
+				return static_cast<std::uint32_t>(std::abs(rowDistance) + std::abs(columnDistance)) * Neighbourhood::straightCost;
+			}
+		};
+
+		// Length of a path in tiles, counting diagonal moves as sqrt(2)
+		inline double octileLength(TileId start, const std::vector<TileId>& path, TileId finish, int stride)
+		{
+			std::size_t straight{};
+			std::size_t diagonal{};
+			TileId previous = start;
+
+			auto step = [&](TileId tile) {
+				auto offset = std::abs(static_cast<long long>(tile) - previous);
+				if (offset == 1 || offset == stride) straight++;
+				else diagonal++;
+				previous = tile;
+			};
+
+			for (TileId tile : path) step(tile);
+			if (finish != start) step(finish);
+
+			return straight + diagonal * std::sqrt(2.0);
+		}
+	}
+}
@@ -0,0 +1,349 @@
+#pragma once
+
+#include "types.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		struct OpenNode
+		{
+			std::uint32_t fCost{};
+			std::uint32_t hCost{};
+			TileId tile{};
+
+			// (f, h) packed so lower f and then lower h compare smaller in one comparison
+			std::uint64_t key() const { return static_cast<std::uint64_t>(fCost) << 32 | hCost; }
+			static OpenNode unpack(std::uint64_t key, TileId tile) { return { static_cast<std::uint32_t>(key >> 32), static_cast<std::uint32_t>(key), tile }; }
+		};
+
+		/*
+			Open lists share empty/size/clear/push/pop/memoryUsage. Lists with decreaseKey
+			also have prepare(tileCount), called before a query to size their per-tile
+			index, and decrease(node), which lowers the key of a tile still in the list.
+			Engines call decrease instead of pushing an improved tile again, so those
+			lists never hold stale copies. Without it improved tiles are pushed again
+			and engines skip the stale copies when they're popped.
+		*/
+
+		// Binary min-heap on (f, h)
+		class BinaryHeapOpenList {
+		public:
+			static constexpr bool decreaseKey{ false };
+
+			bool empty() const { return m_nodes.empty(); }
+			std::size_t size() const { return m_nodes.size(); }
+			void clear() { m_nodes.clear(); }
+			const OpenNode& top() const { return m_nodes.front(); }
+			std::size_t memoryUsage() const { return m_nodes.capacity() * sizeof(OpenNode); }
+
+			void push(const OpenNode& node)
+			{
+				m_nodes.push_back(node);
+				std::push_heap(m_nodes.begin(), m_nodes.end(), isWorse);
+			}
+
+			OpenNode pop()
+			{
+				std::pop_heap(m_nodes.begin(), m_nodes.end(), isWorse);
+				OpenNode node = m_nodes.back();
+				m_nodes.pop_back();
+				return node;
+			}
+
+		private:
+			std::vector<OpenNode> m_nodes{};
+
+			// Lower f first, ties broken towards the finish
+			static bool isWorse(const OpenNode& a, const OpenNode& b)
+			{
+				return a.key() > b.key();
+			}
+		};
+
+		/*
+			Min-heap with Arity children per node and a position per tile for decrease-key.
+			Keys and tiles are kept in separate arrays, so the Arity keys compared when
+			sifting down are adjacent, 4 of them fit in half a cache line.
+		*/
+		template <std::size_t Arity>
+		class DaryHeapOpenList {
+		public:
+			static constexpr bool decreaseKey{ true };
+
+			bool empty() const { return m_keys.empty(); }
+			std::size_t size() const { return m_keys.size(); }
+			std::size_t memoryUsage() const { return capacityBytes(m_keys) + capacityBytes(m_tiles) + capacityBytes(m_position); }
+
+			void clear()
+			{
+				m_keys.clear();
+				m_tiles.clear();
+			}
+
+			void prepare(std::size_t tileCount)
+			{
+				if (m_position.size() < tileCount) m_position.resize(tileCount);
+			}
+
+			void push(const OpenNode& node)
+			{
+				m_keys.emplace_back();
+				m_tiles.emplace_back();
+				siftUp(m_keys.size() - 1, node.key(), node.tile);
+			}
+
+			void decrease(const OpenNode& node)
+			{
+				siftUp(m_position[node.tile], node.key(), node.tile);
+			}
+
+			OpenNode pop()
+			{
+				OpenNode node = OpenNode::unpack(m_keys.front(), m_tiles.front());
+				std::uint64_t key = m_keys.back();
+				TileId tile = m_tiles.back();
+
+				m_keys.pop_back();
+				m_tiles.pop_back();
+				if (!m_keys.empty()) siftDown(0, key, tile);
+
+				return node;
+			}
+
+		private:
+			std::vector<std::uint64_t> m_keys{};
+			std::vector<TileId> m_tiles{};
+			// Index in the heap of every tile pushed during the current query
+			std::vector<std::uint32_t> m_position{};
+
+			void place(std::size_t index, std::uint64_t key, TileId tile)
+			{
+				m_keys[index] = key;
+				m_tiles[index] = tile;
+				m_position[tile] = static_cast<std::uint32_t>(index);
+			}
+
+			// Move the hole at index up until key fits, then fill it
+			void siftUp(std::size_t index, std::uint64_t key, TileId tile)
+			{
+				while (index > 0) {
+					std::size_t parent = (index - 1) / Arity;
+					if (m_keys[parent] <= key) break;
+
+					place(index, m_keys[parent], m_tiles[parent]);
+					index = parent;
+				}
+
+				place(index, key, tile);
+			}
+
+			void siftDown(std::size_t index, std::uint64_t key, TileId tile)
+			{
+				const std::size_t count = m_keys.size();
+
+				while (true) {
+					std::size_t first = index * Arity + 1;
+					if (first >= count) break;
+
+					std::size_t best = first;
+					std::size_t last = std::min(first + Arity, count);
+					for (std::size_t child = first + 1; child < last; child++)
+						if (m_keys[child] < m_keys[best]) best = child;
+
+					if (m_keys[best] >= key) break;
+
+					place(index, m_keys[best], m_tiles[best]);
+					index = best;
+				}
+
+				place(index, key, tile);
+			}
+		};
+
+		using QuaternaryHeapOpenList = DaryHeapOpenList<4>;
+
+		/*
+			Pairing heap with decrease-key. Push, decrease and meld are O(1), pop pairs up
+			the root's children left to right and melds the pairs right to left. Nodes live
+			in one pool indexed by 32-bit links, a tile's node is found through a per-tile
+			handle, and the pool is emptied with the list.
+		*/
+		class PairingHeapOpenList {
+		public:
+			static constexpr bool decreaseKey{ true };
+
+			bool empty() const { return m_root == none; }
+			std::size_t size() const { return m_size; }
+			std::size_t memoryUsage() const { return capacityBytes(m_nodes) + capacityBytes(m_handle) + capacityBytes(m_pairs); }
+
+			void clear()
+			{
+				m_nodes.clear();
+				m_root = none;
+				m_size = 0;
+			}
+
+			void prepare(std::size_t tileCount)
+			{
+				if (m_handle.size() < tileCount) m_handle.resize(tileCount);
+			}
+
+			void push(const OpenNode& node)
+			{
+				auto index = static_cast<std::uint32_t>(m_nodes.size());
+				m_nodes.push_back({ node.key(), node.tile });
+				m_handle[node.tile] = index;
+
+				m_root = meld(m_root, index);
+				m_size++;
+			}
+
+			void decrease(const OpenNode& node)
+			{
+				std::uint32_t index = m_handle[node.tile];
+				m_nodes[index].key = node.key();
+				if (index == m_root) return;
+
+				// Cut the subtree out of its sibling list and meld it back in at the root
+				Node& cut = m_nodes[index];
+				Node& previous = m_nodes[cut.previous];
+				if (previous.child == index) previous.child = cut.sibling;
+				else previous.sibling = cut.sibling;
+				if (cut.sibling != none) m_nodes[cut.sibling].previous = cut.previous;
+				cut.sibling = none;
+
+				m_root = meld(m_root, index);
+			}
+
+			OpenNode pop()
+			{
+				const Node& root = m_nodes[m_root];
+				OpenNode node = OpenNode::unpack(root.key, root.tile);
+
+				m_pairs.clear();
+				for (std::uint32_t child = root.child; child != none;) {
+					std::uint32_t second = m_nodes[child].sibling;
+					std::uint32_t next = second != none ? m_nodes[second].sibling : none;
+
+					m_nodes[child].sibling = none;
+					if (second != none) m_nodes[second].sibling = none;
+
+					m_pairs.push_back(meld(child, second));
+					child = next;
+				}
+
+				m_root = none;
+				for (auto pair = m_pairs.rbegin(); pair != m_pairs.rend(); ++pair) m_root = meld(*pair, m_root);
+
+				m_size--;
+				return node;
+			}
+
+		private:
+			static constexpr std::uint32_t none{ ~std::uint32_t{} };
+
+			struct Node
+			{
+				std::uint64_t key{};
+				TileId tile{};
+				std::uint32_t child{ none };
+				std::uint32_t sibling{ none };
+				// Parent for a first child, the sibling before it otherwise
+				std::uint32_t previous{ none };
+			};
+
+			std::vector<Node> m_nodes{};
+			std::vector<std::uint32_t> m_handle{};
+			// Scratch for pop, kept so it doesn't allocate
+			std::vector<std::uint32_t> m_pairs{};
+			std::uint32_t m_root{ none };
+			std::size_t m_size{};
+
+			// The root with the larger key becomes the first child of the other
+			std::uint32_t meld(std::uint32_t first, std::uint32_t second)
+			{
+				if (first == none) return second;
+				if (second == none) return first;
+				if (m_nodes[second].key < m_nodes[first].key) std::swap(first, second);
+
+				Node& parent = m_nodes[first];
+				Node& child = m_nodes[second];
+				child.sibling = parent.child;
+				child.previous = first;
+				if (parent.child != none) m_nodes[parent.child].previous = second;
+				parent.child = second;
+
+				return first;
+			}
+		};
+
+		/*
+			Bucket queue (Dial's algorithm) for integer f costs. Buckets form a ring
+			indexed by f, and pop scans forward from the last popped f, so push and
+			pop are O(1) amortised. Every key pushed has to be within spread of the
+			smallest key in the list, which holds for a consistent heuristic when
+			spread covers the largest step cost plus one. Keys are compared modulo
+			2^32, so f may wrap around on very long paths.
+
+			Ties pop newest first, which like the heap's tie break favours tiles
+			closer to the finish. The default spread covers A* with any neighbourhood,
+			where f grows by at most twice the largest step cost.
+		*/
+		class BucketOpenList {
+		public:
+			static constexpr bool decreaseKey{ false };
+
+			explicit BucketOpenList(std::uint32_t spread = 512)
+			{
+				std::size_t count{ 1 };
+				while (count <= spread) count *= 2;
+
+				m_buckets.resize(count);
+				m_mask = count - 1;
+			}
+
+			bool empty() const { return m_size == 0; }
+			std::size_t size() const { return m_size; }
+
+			void clear()
+			{
+				for (auto& bucket : m_buckets) bucket.clear();
+				m_size = 0;
+			}
+
+			void push(const OpenNode& node)
+			{
+				// Scanning starts at the smallest key, an empty list starts over at the new one
+				if (m_size == 0 || static_cast<std::int32_t>(node.fCost - m_current) < 0) m_current = node.fCost;
+
+				m_buckets[node.fCost & m_mask].push_back(node);
+				m_size++;
+			}
+
+			OpenNode pop()
+			{
+				while (m_buckets[m_current & m_mask].empty()) m_current++;
+
+				auto& bucket = m_buckets[m_current & m_mask];
+				OpenNode node = bucket.back();
+				bucket.pop_back();
+				m_size--;
+				return node;
+			}
+
+			std::size_t memoryUsage() const
+			{
+				std::size_t bytes = m_buckets.capacity() * sizeof(std::vector<OpenNode>);
+				for (const auto& bucket : m_buckets) bytes += bucket.capacity() * sizeof(OpenNode);
+				return bytes;
+			}
+
+		private:
+			std::vector<std::vector<OpenNode>> m_buckets{};
+			std::size_t m_mask{};
+			std::size_t m_size{};
+			// Smallest key that can still be in the list
+			std::uint32_t m_current{};
+		};
+	}
+}
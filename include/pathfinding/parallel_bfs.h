@@ -0,0 +1,74 @@
+#pragma once
+
+#include "map.h"
+#include "control.h"
+#include "bitgrid.h"
+#include "thread_pool.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		/*
+			Level synchronous breadth first search for single large maps. Each level is
+			split over a thread pool, either top-down (frontier tiles claim their
+			neighbours in an atomic visited bitmap) or bottom-up (unvisited tiles look
+			for a neighbour on the frontier), switching on the frontier size. Small
+			levels run on the calling thread, where the pool would only add overhead.
+
+			Finds the same path lengths as BreadthFirstEngine, the order of checked
+			tiles within one level may differ.
+		*/
+		class ParallelBreadthFirstEngine {
+		public:
+			// 0 uses one thread per hardware thread, the pool starts on the first search
+			explicit ParallelBreadthFirstEngine(std::size_t threads = 0) : m_threads{ threads } {}
+
+			// Takes effect on the next search, 1 runs every level on the calling thread without a pool
+			void setThreads(std::size_t threads);
+
+			void search(const Map& map, Position startTile, Position finishTile, SearchResult& result, SearchControl* control = nullptr);
+			std::size_t memoryUsage() const;
+
+		private:
+			std::size_t m_threads{};
+			std::unique_ptr<ThreadPool> m_pool{};
+
+			BitGrid m_walkable{};
+			std::size_t m_walkableCount{};
+			std::uint64_t m_revision{};
+			std::vector<TileId> m_changed{};
+
+			// One bit per tile, distances are only valid for visited tiles
+			std::unique_ptr<std::atomic<std::uint64_t>[]> m_visited{};
+			std::size_t m_visitedWords{};
+			std::vector<std::uint32_t> m_distance{};
+
+			std::vector<TileId> m_frontier{};
+			// Next level, one buffer per chunk so the order doesn't depend on the threads
+			std::vector<std::vector<TileId>> m_next{};
+
+			// Current query
+			const std::uint8_t* m_cells{};
+			std::array<std::ptrdiff_t, 4> m_offsets{};
+
+			void sync(const Map& map);
+			bool isVisited(TileId tile, std::memory_order order = std::memory_order_relaxed) const
+			{
+				return (m_visited[tile >> 6].load(order) >> (tile & 63)) & 1;
+			}
+
+			void topDown(std::size_t chunk, std::size_t chunkSize, std::uint32_t level);
+			void bottomUp(std::size_t chunk, std::size_t chunkWords, std::uint32_t level);
+			// Runs count chunks on the pool, or inline when there's only one or no pool
+			void forEachChunk(std::size_t count, const std::function<void(std::size_t)>& task);
+
+			// Frontier size at which a level is worth splitting
+			static constexpr std::size_t parallelFrontier{ 4096 };
+			static constexpr std::size_t topDownChunk{ 1024 };
+			static constexpr std::size_t bottomUpChunkWords{ 256 };
+			// Switch to bottom-up when the frontier is above unvisited / alpha, back below walkable / beta
+			static constexpr std::size_t alpha{ 14 };
+			static constexpr std::size_t beta{ 24 };
+		};
+	}
+}
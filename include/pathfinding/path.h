@@ -0,0 +1,22 @@
+#pragma once
+
+#include "types.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		// Walk parent links back from the finish, the path excludes the start and finish tiles
+		template <typename Parents>
+		void reconstructPath(const Parents& parent, TileId start, TileId finish, std::vector<TileId>& path)
+		{
+			path.clear();
+
+			for (TileId tile = parent[finish]; tile != start; tile = parent[tile]) {
+				path.push_back(tile);
+			}
+
+			// Reverse path to right way
+			std::reverse(path.begin(), path.end());
+		}
+	}
+}
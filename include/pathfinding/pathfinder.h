@@ -0,0 +1,91 @@
+#pragma once
+
+#include "bfs.h"
+#include "astar.h"
+#include "jps.h"
+#include "bidirectional.h"
+#include "hierarchical.h"
+#include "dstar_lite.h"
+#include "parallel_bfs.h"
+#include "flood_fill.h"
+#include "dial.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		// Short, stable name used in benchmark output and on the command line
+		const char* methodName(PathfindingMethod method);
+		const char* movementName(Movement movement);
+		const char* openListName(OpenListKind kind);
+
+		// Does the method take the movement into account, the others stay four connected
+		inline bool movesDiagonally(PathfindingMethod method, Movement movement) { return method == AStar && movement != Movement::FourConnected; }
+
+		// Owns one engine per method so repeated queries reuse their buffers
+		class Pathfinder {
+		public:
+
+			// Run the selected search from start to finish, a cancelled search isn't found. The map
+			// is only read, so threads with their own Pathfinder can share it.
+			void findPath(const Map& map, Position start, Position finish, PathfindingMethod method, SearchResult& result, SearchControl* control = nullptr);
+			// Same from map.start() to map.finish()
+			void findPath(const Map& map, PathfindingMethod method, SearchResult& result, SearchControl* control = nullptr)
+			{
+				findPath(map, map.start(), map.finish(), method, result, control);
+			}
+
+			// Threads the parallel breadth first search splits its levels over, 0 uses one per hardware thread
+			void setSearchThreads(std::size_t threads) { m_parallelBreadthFirst.setThreads(threads); }
+
+			// Landmarks used by the Landmarks method, the table is rebuilt on its next query
+			void setLandmarkCount(std::size_t count) { m_landmarks.setCount(count); }
+
+			// Movement for the methods that support diagonal moves, four connected by default
+			void setMovement(Movement movement) { m_movement = movement; }
+			Movement movement() const { return m_movement; }
+
+			// Open list for the A* and landmark methods, a binary heap by default
+			void setOpenList(OpenListKind kind) { m_openList = kind; }
+			OpenListKind openList() const { return m_openList; }
+
+		private:
+			BreadthFirstEngine m_breadthFirst{};
+			AStarEngine m_aStar{};
+			BasicAStarEngine<QuaternaryHeapOpenList> m_aStarQuaternary{};
+			BasicAStarEngine<PairingHeapOpenList> m_aStarPairing{};
+			BasicAStarEngine<BucketOpenList> m_aStarBucket{};
+			JumpPointEngine m_jumpPoint{};
+			BidirectionalBreadthFirstEngine m_bidirectionalBreadthFirst{};
+			BidirectionalAStarEngine m_bidirectionalAStar{};
+			HierarchicalEngine m_hierarchical{};
+			DStarLiteEngine m_incremental{};
+			ParallelBreadthFirstEngine m_parallelBreadthFirst{};
+			FloodFillEngine m_floodFill{};
+			LandmarkTable m_landmarks{};
+			DialEngine m_dial{};
+			Movement m_movement{ Movement::FourConnected };
+			OpenListKind m_openList{ OpenListKind::BinaryHeap };
+
+			// Calls search(engine) with the A* engine for the selected open list, returns its memory use
+			template <typename Search>
+			std::size_t withAStar(const Search& search)
+			{
+				switch (m_openList)
+				{
+				case OpenListKind::QuaternaryHeap:
+					search(m_aStarQuaternary);
+					return m_aStarQuaternary.memoryUsage();
+				case OpenListKind::PairingHeap:
+					search(m_aStarPairing);
+					return m_aStarPairing.memoryUsage();
+				case OpenListKind::Bucket:
+					search(m_aStarBucket);
+					return m_aStarBucket.memoryUsage();
+				default:
+					search(m_aStar);
+					return m_aStar.memoryUsage();
+				}
+			}
+		};
+	}
+}
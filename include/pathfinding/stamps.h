@@ -0,0 +1,43 @@
+#pragma once
+
+#include "types.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		/*
+			Per-tile generation stamps. A tile's search data is only valid when its stamp
+			belongs to the current query, so starting a new query is a counter increment
+			instead of clearing every array.
+		*/
+		class TileStamps {
+		public:
+
+			// Start a new query over a map with the given number of tiles
+			void prepare(std::size_t size)
+			{
+				if (m_stamps.size() != size || m_generation >= maxGeneration) {
+					m_stamps.assign(size, 0);
+					m_generation = 0;
+				}
+
+				// Even values mark seen tiles, odd values closed ones
+				m_generation += 2;
+			}
+
+			bool isSeen(TileId tile) const { return m_stamps[tile] >= m_generation; }
+			bool isClosed(TileId tile) const { return m_stamps[tile] == m_generation + 1; }
+
+			void open(TileId tile) { m_stamps[tile] = m_generation; }
+			void close(TileId tile) { m_stamps[tile] = m_generation + 1; }
+
+			std::size_t memoryUsage() const { return m_stamps.capacity() * sizeof(std::uint32_t); }
+
+		private:
+			static constexpr std::uint32_t maxGeneration{ ~std::uint32_t{} - 2 };
+
+			std::vector<std::uint32_t> m_stamps{};
+			std::uint32_t m_generation{};
+		};
+	}
+}
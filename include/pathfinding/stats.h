@@ -0,0 +1,34 @@
+#pragma once
+
+#include "map.h"
+
+#include <string>
+
+namespace engine {
+	namespace pathfinding {
+
+		// One finished query with the counters of its search, as written by the exporters
+		struct SearchRecord
+		{
+			PathfindingMethod method{};
+			int rows{};
+			int columns{};
+			Position start{};
+			Position finish{};
+			bool found{};
+			// Moves from start to finish, 0 when not found
+			std::size_t pathLength{};
+			double cost{};
+			SearchStats stats{};
+		};
+
+		SearchRecord makeRecord(const Map& map, PathfindingMethod method, const SearchResult& result);
+
+		/*
+			Write records as a CSV table with a header row, or as a JSON array with one
+			object per record. Both return false if the file can't be written.
+		*/
+		bool writeStatsCsv(const std::string& path, const std::vector<SearchRecord>& records);
+		bool writeStatsJson(const std::string& path, const std::vector<SearchRecord>& records);
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "types.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace engine {
+	namespace pathfinding {
+
+		/*
+			Fixed set of worker threads with one task deque each. A batch is cut into
+			ranges of indices dealt round robin over the deques. Workers take ranges
+			from the back of their own deque and steal from the front of the others
+			once it's empty, so uneven queries still keep every core busy.
+		*/
+		class ThreadPool {
+		public:
+			// Called with the worker number and the index of the item
+			using Task = std::function<void(std::size_t worker, std::size_t index)>;
+
+			// 0 uses one thread per hardware thread
+			explicit ThreadPool(std::size_t threads = 0);
+			~ThreadPool();
+
+			ThreadPool(const ThreadPool&) = delete;
+			ThreadPool& operator=(const ThreadPool&) = delete;
+
+			std::size_t size() const { return m_threads.size(); }
+
+			// Runs task for every index in [0, count) and waits for all of them, one batch at a time
+			void run(std::size_t count, const Task& task);
+
+		private:
+			struct Range
+			{
+				const Task* task{};
+				std::size_t begin{};
+				std::size_t end{};
+			};
+
+			struct Queue
+			{
+				std::mutex mutex{};
+				std::deque<Range> ranges{};
+			};
+
+			std::vector<std::unique_ptr<Queue>> m_queues{};
+			std::vector<std::thread> m_threads{};
+
+			std::mutex m_mutex{};
+			std::condition_variable m_wake{};
+			std::condition_variable m_done{};
+			std::uint64_t m_batch{};
+			std::atomic<std::size_t> m_remaining{};
+			bool m_stopping{};
+
+			void work(std::size_t worker);
+			bool pop(std::size_t worker, Range& range);
+			bool steal(std::size_t worker, Range& range);
+		};
+	}
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "map.h"
+#include "mapped_file.h"
+
+#include <string>
+
+namespace engine {
+	namespace pathfinding {
+
+		/*
+			Search traces store the checked tiles of a search in expansion order. Each tile
+			is the zigzag encoded difference to the one before it, written as a LEB128
+			varint. Neighbouring expansions are usually close, so most steps take one or
+			two bytes instead of four. Every traceKeyframeInterval steps a keyframe records
+			the byte offset and previous tile, so any step is at most that many decodes away.
+		*/
+		constexpr inline std::size_t traceKeyframeInterval{ 4096 };
+
+		struct TraceKeyframe
+		{
+			std::uint64_t offset{};
+			TileId previous{};
+			std::uint32_t reserved{};
+		};
+
+		/*
+			Checks of a trace read from a file. Each keyframe block is decoded with bounds
+			checks the first time a cursor enters it, so only the blocks replay reaches are
+			read. A block that fails shows every one of its steps as the fallback tile.
+		*/
+		struct TraceBlockChecks
+		{
+			enum BlockState : std::uint8_t { Unchecked, Valid, Corrupt };
+
+			std::vector<std::uint8_t> blocks{};
+			// Size of the map, every decoded tile has to be inside it and off its border
+			int rows{};
+			int columns{};
+			TileId fallback{};
+		};
+
+		// Read-only trace, in memory or mapped from a file
+		struct TraceView
+		{
+			const std::uint8_t* bytes{};
+			std::size_t byteCount{};
+			const TraceKeyframe* keyframes{};
+			std::size_t keyframeCount{};
+			std::size_t steps{};
+			// Only set for traces read from files, recorded ones are trusted
+			TraceBlockChecks* checks{};
+		};
+
+		// Sequential reader, stays valid while the trace it reads only grows
+		class TraceCursor {
+		public:
+			// Position the cursor before the given step
+			void seek(const TraceView& trace, std::size_t step);
+			std::size_t step() const { return m_step; }
+
+			// Decode the tile at the current step and move past it
+			TileId next(const TraceView& trace)
+			{
+				if (trace.checks) {
+					if (m_step % traceKeyframeInterval == 0) enterBlock(trace);
+
+					if (m_corrupt) {
+						m_step++;
+						return trace.checks->fallback;
+					}
+				}
+
+				std::uint64_t value{};
+
+				for (int shift{};; shift += 7) {
+					std::uint8_t byte = trace.bytes[m_offset++];
+					value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+					if (!(byte & 0x80)) break;
+				}
+
+				// Undo the zigzag encoding
+				std::int64_t delta = static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+				m_previous = static_cast<TileId>(m_previous + delta);
+				m_step++;
+
+				return m_previous;
+			}
+
+		private:
+			std::size_t m_step{};
+			std::size_t m_offset{};
+			TileId m_previous{};
+			// Inside a block of a file trace that failed its checks
+			bool m_corrupt{};
+
+			// Check the block starting at the current step if it wasn't yet, and start it from its keyframe
+			void enterBlock(const TraceView& trace);
+		};
+
+		// Trace being recorded
+		class SearchTrace {
+		public:
+			static constexpr std::size_t keyframeInterval{ traceKeyframeInterval };
+
+			void clear();
+			void append(TileId tile);
+			void append(const TileId* tiles, std::size_t count);
+
+			std::size_t steps() const { return m_steps; }
+			TraceView view() const { return { m_bytes.data(), m_bytes.size(), m_keyframes.data(), m_keyframes.size(), m_steps }; }
+
+			std::size_t memoryUsage() const { return m_bytes.capacity() + m_keyframes.capacity() * sizeof(TraceKeyframe); }
+
+		private:
+			std::vector<std::uint8_t> m_bytes{};
+			std::vector<TraceKeyframe> m_keyframes{};
+			std::size_t m_steps{};
+			TileId m_previous{};
+		};
+
+		/*
+			Writes the map the search ran on (one cost byte per tile, plus start and finish),
+			the found path and the trace to one file. Returns false if it can't be written.
+			Files use the native byte order, which is little-endian everywhere we build.
+		*/
+		bool writeTrace(const std::string& path, const Map& map, const TraceView& trace, const std::vector<TileId>& searchPath);
+
+		// A trace file mapped into memory, its pages are only read as replay reaches them. Opening
+		// checks the header, path and keyframes, the steps are checked a block at a time by TraceCursor.
+		class MappedTrace {
+		public:
+			MappedTrace() = default;
+			MappedTrace(MappedTrace&& other) noexcept { *this = std::move(other); }
+			MappedTrace& operator=(MappedTrace&& other) noexcept;
+			~MappedTrace() { close(); }
+
+			// Returns false if the file can't be mapped or isn't a valid trace
+			bool open(const std::string& path);
+			void close();
+			bool isOpen() const { return m_file.isOpen(); }
+
+			TraceView view() const
+			{
+				TraceView view = m_view;
+				view.checks = m_checks.get();
+				return view;
+			}
+			// Map the trace was recorded on, with its start and finish
+			Map map() const;
+			const std::vector<TileId>& path() const { return m_path; }
+
+		private:
+			MappedFile m_file{};
+			TraceView m_view{};
+			std::vector<TileId> m_path{};
+			// Behind a pointer so cursors' views stay valid when the trace is moved
+			std::unique_ptr<TraceBlockChecks> m_checks{};
+			const std::uint8_t* m_cells{};
+			int m_rows{};
+			int m_columns{};
+			Position m_start{};
+			Position m_finish{};
+
+			// Checks everything but the steps and sets up their block checks
+			bool validate();
+		};
+	}
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+// Dependencies
+#include <vector>
+#include <array>
+#include <queue>
+#include <unordered_map>
+#include <memory>
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+
+namespace engine {
+	namespace pathfinding {
+
+		// Row/column coordinates of a tile
+		struct Position
+		{
+			int row{};
+			int column{};
+
+			bool operator==(const Position& other) const { return row == other.row && column == other.column; }
+			bool operator!=(const Position& other) const { return !(*this == other); }
+		};
+
+		// Linear index of a tile in the padded, row-major map storage
+		using TileId = std::uint32_t;
+		constexpr inline TileId invalidTile{ ~TileId{} };
+
+		enum PathfindingMethod {
+			BreadthFirst,
+			AStar,
+			JumpPoint,
+			BidirectionalBreadthFirst,
+			BidirectionalAStar,
+			Hierarchical,
+			Incremental,
+			ParallelBreadthFirst,
+			FloodFill,
+			Landmarks,
+			Dial,
+
+			PathfindingMethodCount
+		};
+
+		// Moves a search may make, only A* goes beyond four connected
+		enum class Movement {
+			FourConnected,
+			// Diagonal moves may cut past obstacle corners
+			EightConnected,
+			// Diagonal moves can't squeeze between two obstacles
+			EightConnectedNoSqueezing,
+			// Diagonal moves can't touch an obstacle, the MovingAI rule
+			EightConnectedNoCutting,
+
+			MovementCount
+		};
+
+		// Open list behind the A* and landmark methods, see open_list.h
+		enum class OpenListKind {
+			BinaryHeap,
+			QuaternaryHeap,
+			PairingHeap,
+			Bucket,
+
+			OpenListKindCount
+		};
+
+		// How much work a search did, counted by the engines and timed by Pathfinder
+		struct SearchStats
+		{
+			// Tiles whose neighbours were looked at, including the start
+			std::uint64_t expanded{};
+			// Tiles added to the open list or frontier, every copy of a re-pushed tile counts
+			std::uint64_t pushed{};
+			// Outdated copies popped off the open list and skipped
+			std::uint64_t stalePops{};
+			// Largest size of the open list or frontier
+			std::uint64_t peakOpen{};
+			// Bytes held by the engine's buffers, they never shrink so this is also their peak
+			std::uint64_t peakMemory{};
+			// Bringing cached data (bit grids, clusters, landmarks) up to date with the map
+			double preprocessSeconds{};
+			// The search itself, including building the path
+			double searchSeconds{};
+		};
+
+		inline double secondsSince(std::chrono::steady_clock::time_point start)
+		{
+			return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		template <typename T>
+		std::size_t capacityBytes(const std::vector<T>& buffer) { return buffer.capacity() * sizeof(T); }
+
+		struct SearchResult
+		{
+			// Path to finish, without the start and finish tiles
+			std::vector<TileId> path{};
+			// All checked tiles in the order they were expanded
+			std::vector<TileId> checked{};
+			// Total cost of the path, one per step
+			double cost{};
+			bool found{};
+			SearchStats stats{};
+
+			// Empty the result but keep its buffers for the next query
+			void clear()
+			{
+				path.clear();
+				checked.clear();
+				cost = 0;
+				found = false;
+				stats = {};
+			}
+		};
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "resources.h"
+
+#include <string>
+
+// Profiling is on in debug builds, -DPATHFINDING_PROFILE=ON keeps it in release builds
+#if !defined(NDEBUG) || defined(PATHFINDING_PROFILE)
+#define PATHFINDING_PROFILER 1
+#endif
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef PATHFINDING_PROFILER
+// Time the rest of the enclosing block, name has to be a string literal
+#define PROFILE_SCOPE(name) engine::profiler::Scope PROFILE_CONCAT(profileScope, __LINE__){ name }
+// Close the previous frame and start a new one, once at the top of the main loop
+#define PROFILE_FRAME() engine::profiler::beginFrame()
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#endif
+
+namespace engine {
+	namespace profiler {
+
+		/*
+			Records nested scopes of the main thread for the last frameCount frames.
+			Top level scopes are the subsystems stacked in the frame graph, anything
+			nested inside them only shows up in the exported trace.
+		*/
+		constexpr std::size_t frameCount{ 150 };
+
+		// Is the frame graph drawn
+		extern bool graphVisible;
+
+		void initialize();
+		void beginFrame();
+		void begin(const char* name);
+		void end();
+
+		class Scope {
+		public:
+			explicit Scope(const char* name) { begin(name); }
+			~Scope() { end(); }
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+		};
+
+		void toggleGraph();
+		void render();
+
+		// Write the recorded frames as Chrome trace_event JSON, returns false if profiling is compiled out or the file can't be written
+		bool exportTrace(const std::string& path);
+	}
+}
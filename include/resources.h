@@ -8,6 +8,9 @@
 #include <queue>
 #include <unordered_map>
 #include <algorithm>
+#include <thread>
+#include <atomic>
+#include <cmath>
 #include <stdlib.h>
 
 #include <TGUI/TGUI.hpp>
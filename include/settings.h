@@ -11,15 +11,26 @@ namespace settings {
 
 	// Grid
 	const inline sf::Vector2f gridSize{ 1600, 800 };
-	constexpr inline std::array rowDirections = { 0, 0, -1, 1 };
-	constexpr inline std::array colDirections = { -1, 1, 0, 0 };
 	constexpr inline int gridRows{10};
 	constexpr inline int gridColumns{ gridRows * 2};
 	constexpr inline float gridGap{3};
 	constexpr inline int randomGridMaxCoverage{50};
+	// Tiles smaller than this on screen are drawn from a texture, one texel per tile
+	constexpr inline float detailTilePixels{ 4 };
+	// Zoom stops once a tile is this large on screen
+	constexpr inline float maxTilePixels{ 96 };
+	// Zoom step per mouse wheel notch
+	constexpr inline float zoomStep{ 1.25f };
+	// Largest texture page edge, in tiles
+	constexpr inline int texturePageSize{ 2048 };
+	// Largest window of a chunked map copied into the grid, in tiles
+	constexpr inline int chunkedWindowRows{ 2048 };
+	constexpr inline int chunkedWindowColumns{ chunkedWindowRows * 2 };
 	const inline sf::Color tileColor{ 197, 199, 200};
 	const inline sf::Color tileHoveredColor{ 197, 199, 200, 200};
 	const inline sf::Color tileObstacleColor{ 197, 199, 200, 80 };
+	// Open tiles shade from tileColor towards this as their cost goes up to the maximum
+	const inline sf::Color heavyTerrainColor{ 139, 98, 57 };
 	const inline sf::Color startTileColor{ sf::Color::Green };
 	const inline sf::Color finishTileColor{ sf::Color::Red };
 	const inline sf::Color pathTileColor{ sf::Color::Color(153, 206, 255)};
@@ -2,6 +2,7 @@
 #pragma once
 
 #include "../include/resources.h"
+#include "pathfinding/stats.h"
 
 namespace engine {
 	namespace ui {
@@ -11,20 +12,35 @@ namespace engine {
 		extern tgui::VerticalLayout::Ptr titleWrapper;
 		extern tgui::Label::Ptr titleText;
 		extern tgui::VerticalLayout::Ptr algorithmWrapper;
+		extern tgui::HorizontalLayout::Ptr algorithmHeader;
 		extern tgui::Label::Ptr algorithmText;
+		extern tgui::Button::Ptr statsButton;
 		extern tgui::ComboBox::Ptr algorithmSelector;
+		extern tgui::CheckBox::Ptr diagonalCheckBox;
 		extern tgui::VerticalLayout::Ptr speedWrapper;
+		extern tgui::HorizontalLayout::Ptr speedHeader;
 		extern tgui::Label::Ptr speedText;
+		extern tgui::Button::Ptr skipButton;
 		extern tgui::Slider::Ptr speedSlider; 
 		extern tgui::VerticalLayout::Ptr audioWrapper;
 		extern tgui::Label::Ptr audioText;
 		extern tgui::Slider::Ptr audioSlider;
+		extern tgui::VerticalLayout::Ptr brushWrapper;
+		extern tgui::Label::Ptr brushText;
+		extern tgui::Slider::Ptr brushSlider;
 		extern tgui::BitmapButton::Ptr startButton;
 		extern tgui::VerticalLayout::Ptr buttonsWrapper;
 		extern tgui::Button::Ptr clearGridButton;
 		extern tgui::Button::Ptr fillGridButton;
 		extern tgui::Button::Ptr randomGridButton;
 		extern tgui::SeparatorLine::Ptr line;
+		extern tgui::HorizontalLayout::Ptr timelineWrapper;
+		extern tgui::Label::Ptr timelineText;
+		extern tgui::Slider::Ptr timelineSlider;
+		extern tgui::Panel::Ptr statsPanel;
+		extern tgui::Label::Ptr statsText;
+		extern tgui::Button::Ptr exportJsonButton;
+		extern tgui::Button::Ptr exportCsvButton;
 
 		// Is search in process
 		extern bool inProcess;
@@ -35,6 +51,12 @@ namespace engine {
 		// Ui functions
 		void setProcessState(bool state);
 		void updateButton();
+		void updateSpeedText();
+		void updateBrushText();
+		// Show the counters of the last finished search, and how many are kept for export
+		void showStats(const engine::pathfinding::SearchRecord& record, std::size_t recorded);
+		// Move the timeline to the revealed step without seeking
+		void updateTimeline(std::size_t revealed, std::size_t steps);
 		void onStartButtonClick();
 
 		void render();
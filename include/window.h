@@ -13,7 +13,9 @@ namespace engine {
 		extern sf::Image icon;
 
 		// Animation
-		extern float animationFrame;
+		// Seconds since the previous frame
+		extern float frameTime;
+		// Checked tiles revealed per second
 		extern float animationSpeed;
 
 		void create();
@@ -1,16 +1,16 @@
-
 #include "../include/grid.h"
 #include "../include/window.h"
 #include "../include/settings.h"
 #include "../include/utils.h"
 #include "../include/ui.h"
 #include "../include/audio.h"
+#include "../include/profiler.h"
 
 namespace engine {
 
 	Grid grid{ settings::gridSize, settings::gridRows, settings::gridColumns };
 
-	Grid::Grid(const sf::Vector2f& size, int rows, int columns) : m_gridSize{ size }, m_rows{ rows }, m_columns{ columns }
+	Grid::Grid(const sf::Vector2f& size, int rows, int columns) : m_gridSize{ size }, m_map{ rows, columns }, m_rows{ rows }, m_columns{ columns }, m_searchMap{ m_map }
 	{
 		// Place the grid at the center at the x coordinate and slightly lower than the center at the y coordinate
 		m_gridRec.setPosition({ settings::windowSize.x / 2 - m_gridSize.x / 2, settings::windowSize.y * 0.55f - m_gridSize.y / 2 });
@@ -19,41 +19,71 @@ namespace engine {
 		// Set background color
 		m_gridRec.setFillColor(sf::Color::Black);
 
-		// Create tiles
-		create(rows, columns);
+		// Set tile size
+		m_tileSize = { m_gridSize.x / m_columns, m_gridSize.y / m_rows };
+
+		m_history.reset(m_map);
+		m_searched = m_history.snapshot(m_map);
+
+		resetCamera();
+		resetTiles();
+	}
+
+	Grid::~Grid()
+	{
+		stopSearch();
+	}
+
+	void Grid::resize(int rows, int columns)
+	{
+		setMap(pathfinding::Map{ rows, columns });
 	}
 
-	void Grid::create(int rows, int columns)
+	bool Grid::loadMap(const std::string& path)
 	{
-		assert(rows > 0 && columns > 0);
+		pathfinding::Map map{ 1, 1 };
 
-		if (m_tiles.size() > 0) m_tiles.clear();
+		if (!pathfinding::loadMovingAiMap(path, map)) return false;
 
-		/*
-			1 represents open paths,
-			0 represents obstacles,
-			S represents the start point,
-			F represents the finish point.
-		*/
+		// The default start and finish corners may be obstacles in the loaded map
+		map.setWalkable(map.start(), true);
+		map.setWalkable(map.finish(), true);
 
-		for (int x{}; x < rows; x++) {
-			std::vector<char> row{};
-			for (int y{}; y < columns; y++) {
-				row.push_back('1');
-			}
-			m_tiles.push_back(row);
-		}
+		setMap(std::move(map));
+		return true;
+	}
 
-		// Initialise start and finish tiles
-		m_tiles[0][0] = 'S';
-		m_tiles[rows - 1][columns - 1] = 'F';
+	bool Grid::loadChunkedMap(const std::string& path, pathfinding::Position corner)
+	{
+		pathfinding::ChunkedMap chunked{};
 
+		if (!chunked.open(path) || !chunked.isInside(corner)) return false;
 
-		m_startTile = { 0, 0 };
-		m_finishTile = { rows - 1, columns - 1 };
+		pathfinding::Map map{ std::min(chunked.rows() - corner.row, settings::chunkedWindowRows), std::min(chunked.columns() - corner.column, settings::chunkedWindowColumns) };
+		chunked.extract(corner, map);
+
+		setMap(std::move(map));
+		return true;
+	}
+
+	void Grid::setMap(pathfinding::Map map)
+	{
+		ui::setProcessState(false);
+		clearPath();
+
+		m_map = std::move(map);
+		m_rows = m_map.rows();
+		m_columns = m_map.columns();
+
+		// A new map starts a new history
+		m_searchMap = m_map;
+		m_history.reset(m_map);
+		m_searched = m_history.snapshot(m_map);
 
-		// Set tile size
 		m_tileSize = { m_gridSize.x / m_columns, m_gridSize.y / m_rows };
+
+		resetCamera();
+		resetTiles();
 	}
 
 	bool Grid::isMouseOverGrid() const
@@ -71,275 +101,642 @@ namespace engine {
 	// P.S: This is because we are returning the desired tile relative to the mouse location, and we need to make sure it is over the grid. 
 	// We could do without this, but then we would have to check each tile through a for loop, which is more expensive
 
-	sf::Vector2i Grid::getTileUnderMouse() const
+	pathfinding::Position Grid::getTileUnderMouse() const
 	{
-		const auto& mousePos = engine::window::mousePos;
+		// Screen to world through the camera
+		sf::Vector2f mousePos = engine::window::windowPtr->mapPixelToCoords(engine::window::mousePos, m_camera);
 
-		int relativeX = mousePos.x - m_gridRec.getPosition().x;
-		int relativeY = mousePos.y - m_gridRec.getPosition().y;
+		float relativeX = mousePos.x - m_gridRec.getPosition().x;
+		float relativeY = mousePos.y - m_gridRec.getPosition().y;
 
-		sf::Vector2f tileSize = { m_gridSize.x / m_columns, m_gridSize.y / m_rows };
-
-		return {engine::utils::clamp(static_cast<int>(relativeY / tileSize.y), 0, m_rows - 1), 
-			engine::utils::clamp(static_cast<int>(relativeX / tileSize.x), 0, m_columns - 1)};
+		return {engine::utils::clamp(static_cast<int>(relativeY / m_tileSize.y), 0, m_rows - 1), 
+			engine::utils::clamp(static_cast<int>(relativeX / m_tileSize.x), 0, m_columns - 1)};
 	}
 
 	sf::Vector2f Grid::getTilePosition(int row, int col) const
 	{
-		return {m_gridRec.getPosition().x + m_tileSize.x * col + settings::gridGap,
-			m_gridRec.getPosition().y + m_tileSize.y * row + settings::gridGap};
+		return {m_gridRec.getPosition().x + m_tileSize.x * col + tileGap(),
+			m_gridRec.getPosition().y + m_tileSize.y * row + tileGap()};
 	}
 
-	void Grid::drawPath(sf::RectangleShape& tile)
+	sf::Vector2f Grid::getTilePosition(pathfinding::TileId tile) const
 	{
-		if (m_checkedTiles.size() == 0) {
-			return ui::setProcessState(false);
-		}
+		auto position = m_map.position(tile);
 
-		// Update animation every two animation frames
-		if (static_cast<int>(engine::window::animationFrame) >= 2 && m_checkedTilesAnimation.size() < m_checkedTiles.size())  {
-			m_checkedTilesAnimation.push_back(m_checkedTiles[m_checkedTilesAnimation.size()]);
+		return getTilePosition(position.row, position.column);
+	}
 
-			// If we finished, update ui button
-			if (m_checkedTilesAnimation.size() == m_checkedTiles.size()) ui::setProcessState(false);
+	void Grid::resetCamera()
+	{
+		const auto& position = m_gridRec.getPosition();
+		const auto& size = m_gridRec.getSize();
 
-			engine::window::animationFrame = 0;
+		// World coordinates match the screen until the user zooms
+		m_camera.reset({ position, size });
+		m_camera.setViewport({ position.x / settings::windowSize.x, position.y / settings::windowSize.y,
+			size.x / settings::windowSize.x, size.y / settings::windowSize.y });
 
-			// Play beep sound from 0.1 to 4 pitch
-			engine::audio::playSound(0.1f + (static_cast<float>(m_checkedTilesAnimation.size()) / m_checkedTiles.size() * 4.0f));
-		}
+		m_panning = false;
+		m_rebuildTiles = true;
+	}
 
-		for (auto& vec : m_checkedTilesAnimation) {
+	void Grid::clampCamera()
+	{
+		const auto& position = m_gridRec.getPosition();
+		const auto& world = m_gridRec.getSize();
+		sf::Vector2f size = m_camera.getSize();
+
+		// From the whole grid down to maxTilePixels per tile
+		float smallest = world.x * std::min(m_tileSize.x, m_tileSize.y) / settings::maxTilePixels;
+		float width = engine::utils::clamp(size.x, std::min(smallest, world.x), world.x);
+		m_camera.setSize(size * (width / size.x));
+		size = m_camera.getSize();
+
+		// Keep the grid covering the whole viewport
+		sf::Vector2f center = m_camera.getCenter();
+		center.x = engine::utils::clamp(center.x, position.x + size.x / 2, position.x + world.x - size.x / 2);
+		center.y = engine::utils::clamp(center.y, position.y + size.y / 2, position.y + world.y - size.y / 2);
+		m_camera.setCenter(center);
+	}
 
-			tile.setFillColor(settings::checkedTileColor);
+	float Grid::tilePixels() const
+	{
+		return std::min(m_tileSize.x, m_tileSize.y) * m_gridRec.getSize().x / m_camera.getSize().x;
+	}
 
-			tile.setPosition(getTilePosition(vec.x, vec.y));
+	float Grid::tileGap() const
+	{
+		// Gap is kept the same on screen at any zoom
+		return tilePixels() > settings::gridGap * 4 ? settings::gridGap * m_camera.getSize().x / m_gridRec.getSize().x : 0.f;
+	}
 
-			engine::window::windowPtr->draw(tile);
-		}
+	sf::IntRect Grid::visibleTiles() const
+	{
+		sf::Vector2f corner = m_camera.getCenter() - m_camera.getSize() / 2.f - m_gridRec.getPosition();
+		sf::Vector2f size = m_camera.getSize();
 
-		// If we drew all checked tiles
-		if (m_checkedTilesAnimation.size() == m_checkedTiles.size())
-			for (auto& vec : m_path) {
+		int firstColumn = engine::utils::clamp(static_cast<int>(corner.x / m_tileSize.x), 0, m_columns - 1);
+		int firstRow = engine::utils::clamp(static_cast<int>(corner.y / m_tileSize.y), 0, m_rows - 1);
+		int lastColumn = engine::utils::clamp(static_cast<int>(std::ceil((corner.x + size.x) / m_tileSize.x)), firstColumn + 1, m_columns);
+		int lastRow = engine::utils::clamp(static_cast<int>(std::ceil((corner.y + size.y) / m_tileSize.y)), firstRow + 1, m_rows);
 
-				tile.setFillColor(settings::pathTileColor);
+		return { firstColumn, firstRow, lastColumn - firstColumn, lastRow - firstRow };
+	}
 
-				tile.setPosition(getTilePosition(vec.x, vec.y));
+	std::uint8_t Grid::brushCost() const
+	{
+		return static_cast<std::uint8_t>(ui::brushSlider->getValue());
+	}
 
-				engine::window::windowPtr->draw(tile);
-			}
+	sf::Color Grid::tileColor(pathfinding::TileId tile) const
+	{
+		if (tile == m_map.startId()) return settings::startTileColor;
+		if (tile == m_map.finishId()) return settings::finishTileColor;
+		if (m_overlay[tile] & PathOverlay) return settings::pathTileColor;
+		if (m_overlay[tile] & CheckedOverlay) return settings::checkedTileColor;
+		if (!m_map.isWalkable(tile)) return settings::tileObstacleColor;
+
+		int weight = m_map.cost(tile) - 1;
+		if (weight == 0) return settings::tileColor;
+
+		auto blend = [weight](sf::Uint8 light, sf::Uint8 heavy) {
+			return static_cast<sf::Uint8>(light + (heavy - light) * weight / (pathfinding::Map::maxCost - 1));
+		};
+
+		return { blend(settings::tileColor.r, settings::heavyTerrainColor.r), blend(settings::tileColor.g, settings::heavyTerrainColor.g),
+			blend(settings::tileColor.b, settings::heavyTerrainColor.b) };
 	}
 
-	bool Grid::isValidTile(sf::Vector2i& tile)
+	void Grid::resetTiles()
 	{
-		return tile.x >= 0 && tile.x < m_tiles.size()
-			&& tile.y >= 0 && tile.y < m_tiles[0].size()
-			&& m_tiles[tile.x][tile.y] != '0';
+		m_overlay.assign(m_map.size(), NoOverlay);
+		m_pathShown = false;
+		m_shownStart = m_map.startId();
+		m_shownFinish = m_map.finishId();
+
+		m_rebuildTiles = true;
+		m_dirtyTiles.clear();
+		m_pages.clear();
+		m_dirtyTexels.clear();
 	}
 
-	bool Grid::isVisited(sf::Vector2i& tile, std::vector<std::vector<bool>>& visited)
+	void Grid::redrawTiles()
 	{
-		return !visited[tile.x][tile.y];
+		m_rebuildTiles = true;
+		m_dirtyTexels.clear();
+
+		for (auto& page : m_pages) page->dirty = { 0, 0, page->tiles.width, page->tiles.height };
 	}
 
-	bool Grid::isVisited(sf::Vector2i& tile, std::unordered_map<int, std::unordered_map<int, std::shared_ptr<Tile>>>& visited)
+	void Grid::showEdits(std::uint64_t revision)
 	{
-		return visited[tile.x][tile.y] != nullptr;
+		// Too many edits for the map's change history, redraw it all
+		if (!m_map.changesSince(revision, m_changedTiles)) {
+			redrawTiles();
+			return;
+		}
+
+		for (auto tile : m_changedTiles) refreshTile(tile);
 	}
 
-	std::vector<sf::Vector2i> Grid::breadthFirstSearch()
+	void Grid::buildTiles(const sf::IntRect& visible)
 	{
-		std::queue<sf::Vector2i> q{};
-		q.push(m_startTile);
+		m_rebuildTiles = false;
+		m_visibleTiles = visible;
+		m_dirtyTiles.clear();
+
+		sf::Vector2f size{ m_tileSize.x - tileGap(), m_tileSize.y - tileGap() };
+		m_hoverTile.setSize(size);
+
+		m_vertices.resize(static_cast<std::size_t>(visible.width) * visible.height * 6);
+
+		for (int row{}; row < visible.height; row++) {
+			for (int column{}; column < visible.width; column++) {
+				sf::Vertex* quad = &m_vertices[(static_cast<std::size_t>(row) * visible.width + column) * 6];
+				sf::Vector2f position = getTilePosition(visible.top + row, visible.left + column);
+				sf::Color color = tileColor(m_map.id(visible.top + row, visible.left + column));
+
+				// Two triangles, top left to bottom right
+				quad[0] = sf::Vertex{ position, color };
+				quad[1] = sf::Vertex{ { position.x + size.x, position.y }, color };
+				quad[2] = sf::Vertex{ { position.x, position.y + size.y }, color };
+				quad[3] = quad[2];
+				quad[4] = quad[1];
+				quad[5] = sf::Vertex{ position + size, color };
+			}
+		}
 
-		std::vector<std::vector<bool>> visited(m_rows, std::vector<bool>(m_columns, false));
-		std::vector<std::vector<sf::Vector2i>> parents(m_rows, std::vector<sf::Vector2i>(m_columns, {-1, -1}));
- 		visited[m_startTile.x][m_startTile.y] = true;
+		// Fall back to drawing from memory without a vertex buffer, it's still one draw call
+		m_useBuffer = sf::VertexBuffer::isAvailable()
+			&& (m_tileBuffer.getVertexCount() >= m_vertices.size() || m_tileBuffer.create(m_vertices.size()))
+			&& m_tileBuffer.update(m_vertices.data(), m_vertices.size(), 0);
+	}
 
-		while (!q.empty()) {
+	void Grid::refreshTile(pathfinding::TileId tile)
+	{
+		if (!m_pages.empty()) m_dirtyTexels.push_back(tile);
 
-			sf::Vector2i current = q.front();
-			q.pop();
+		auto position = m_map.position(tile);
 
-			if (m_tiles[current.x][current.y] == 'F') {
+		if (m_rebuildTiles || !m_visibleTiles.contains(position.column, position.row)) return;
 
-				std::vector<sf::Vector2i> path{};
-				sf::Vector2i parent{};
+		int index = (position.row - m_visibleTiles.top) * m_visibleTiles.width + position.column - m_visibleTiles.left;
+		sf::Color color = tileColor(tile);
+		sf::Vertex* quad = &m_vertices[static_cast<std::size_t>(index) * 6];
 
-				// While we have parents
-				while (parent = parents[current.x][current.y], parent.x != -1) {
-					path.push_back(parent);
-					current = parent;
-				}
+		if (quad[0].color == color) return;
 
-				// Remove start tile from list
-				path.pop_back();
+		for (int i{}; i < 6; i++) quad[i].color = color;
+		m_dirtyTiles.push_back(index);
+	}
 
-				// Reverse path to right way
-				std::reverse(path.begin(), path.end());
+	void Grid::uploadTiles()
+	{
+		if (!m_useBuffer || m_dirtyTiles.empty()) {
+			m_dirtyTiles.clear();
+			return;
+		}
+
+		// A handful of tiles go up one by one, a big batch as one range covering them all
+		if (m_dirtyTiles.size() <= 64) {
+			for (int index : m_dirtyTiles)
+				m_tileBuffer.update(&m_vertices[static_cast<std::size_t>(index) * 6], 6, static_cast<unsigned>(index) * 6);
+		}
+		else {
+			auto [first, last] = std::minmax_element(m_dirtyTiles.begin(), m_dirtyTiles.end());
+			std::size_t begin = static_cast<std::size_t>(*first) * 6;
 
-				return path;
+			m_tileBuffer.update(&m_vertices[begin], static_cast<std::size_t>(*last + 1) * 6 - begin, static_cast<unsigned>(begin));
+		}
+
+		m_dirtyTiles.clear();
+	}
+
+	void Grid::buildPages()
+	{
+		m_pageSize = std::min(static_cast<int>(sf::Texture::getMaximumSize()), settings::texturePageSize);
+		m_pageColumns = (m_columns + m_pageSize - 1) / m_pageSize;
+		m_dirtyTexels.clear();
+
+		for (int row{}; row < m_rows; row += m_pageSize) {
+			for (int column{}; column < m_columns; column += m_pageSize) {
+				auto page = std::make_unique<TexturePage>();
+				page->tiles = { column, row, std::min(m_pageSize, m_columns - column), std::min(m_pageSize, m_rows - row) };
+				page->dirty = { 0, 0, page->tiles.width, page->tiles.height };
+				page->texture.create(page->tiles.width, page->tiles.height);
+
+				m_pages.push_back(std::move(page));
 			}
+		}
+	}
+
+	void Grid::markDirtyPages()
+	{
+		for (auto id : m_dirtyTexels) {
+			auto position = m_map.position(id);
+			auto& page = *m_pages[(position.row / m_pageSize) * m_pageColumns + position.column / m_pageSize];
+			int column = position.column - page.tiles.left;
+			int row = position.row - page.tiles.top;
+
+			// Grow the page's dirty rectangle to take the texel in
+			if (page.dirty.width == 0) {
+				page.dirty = { column, row, 1, 1 };
+				continue;
+			}
+
+			int right = std::max(page.dirty.left + page.dirty.width, column + 1);
+			int bottom = std::max(page.dirty.top + page.dirty.height, row + 1);
+			page.dirty.left = std::min(page.dirty.left, column);
+			page.dirty.top = std::min(page.dirty.top, row);
+			page.dirty.width = right - page.dirty.left;
+			page.dirty.height = bottom - page.dirty.top;
+		}
+
+		m_dirtyTexels.clear();
+	}
+
+	void Grid::uploadPages()
+	{
+		if (m_pages.empty()) buildPages();
+
+		// Patch single texels, or redraw the part of each page around a big change
+		if (m_dirtyTexels.size() > maxTexelUpdates) markDirtyPages();
+
+		for (auto id : m_dirtyTexels) {
+			auto position = m_map.position(id);
+			auto& page = *m_pages[(position.row / m_pageSize) * m_pageColumns + position.column / m_pageSize];
+			int column = position.column - page.tiles.left;
+			int row = position.row - page.tiles.top;
+			sf::Color color = tileColor(id);
+			const sf::Uint8 texel[4]{ color.r, color.g, color.b, color.a };
+
+			if (!page.dirty.contains(column, row)) page.texture.update(texel, 1, 1, column, row);
+		}
+
+		m_dirtyTexels.clear();
 
-			if (m_tiles[current.x][current.y] != 'S') m_checkedTiles.push_back(current);
+		std::vector<sf::Uint8> pixels{};
 
-			// Explore the neighboring cells
-			for (int i{}; i < settings::rowDirections.size(); i++)
-			{
-					int newRow = current.x + settings::rowDirections[i];
-					int newCol = current.y + settings::colDirections[i];
+		for (auto& page : m_pages) {
+			const sf::IntRect dirty = page->dirty;
+			if (dirty.width == 0) continue;
 
-					if (isValidTile(sf::Vector2i{ newRow, newCol }) && isVisited(sf::Vector2i{newRow, newCol}, visited)) {
-						visited[newRow][newCol] = true;
-						parents[newRow][newCol] = current;
-						q.push({ newRow, newCol });
-					}
+			pixels.resize(static_cast<std::size_t>(dirty.width) * dirty.height * 4);
+			sf::Uint8* texel = pixels.data();
+
+			for (int row{}; row < dirty.height; row++) {
+				for (int column{}; column < dirty.width; column++, texel += 4) {
+					sf::Color color = tileColor(m_map.id(page->tiles.top + dirty.top + row, page->tiles.left + dirty.left + column));
+					texel[0] = color.r;
+					texel[1] = color.g;
+					texel[2] = color.b;
+					texel[3] = color.a;
+				}
 			}
+
+			page->texture.update(pixels.data(), dirty.width, dirty.height, dirty.left, dirty.top);
+			page->dirty = {};
+		}
+	}
+
+	void Grid::drawPages(const sf::IntRect& visible)
+	{
+		for (const auto& page : m_pages) {
+			if (!page->tiles.intersects(visible)) continue;
+
+			// One texel per tile, stretched to the tile size
+			sf::Sprite sprite{ page->texture };
+			sprite.setPosition(m_gridRec.getPosition() + sf::Vector2f{ page->tiles.left * m_tileSize.x, page->tiles.top * m_tileSize.y });
+			sprite.setScale(m_tileSize);
+
+			engine::window::windowPtr->draw(sprite);
 		}
+	}
 
-		return {};
+	void Grid::setOverlay(pathfinding::TileId tile, TileOverlay overlay, bool shown)
+	{
+		m_overlay[tile] = shown ? m_overlay[tile] | overlay : m_overlay[tile] & ~overlay;
+		refreshTile(tile);
 	}
 
+	pathfinding::TraceView Grid::traceView() const
+	{
+		return m_replay.isOpen() ? m_replay.view() : m_trace.view();
+	}
 
-	double Grid::heuristic(sf::Vector2i curPos, sf::Vector2i endPos)
+	void Grid::clearOverlay()
 	{
-		return abs(curPos.x - endPos.x) + abs(curPos.y - endPos.y);
+		revealTo(0);
+		hidePath();
 	}
 
-	std::vector<sf::Vector2i> Grid::aStarSearch()
+	void Grid::hidePath()
 	{
-		auto compare = [](const std::shared_ptr<Tile> a, const std::shared_ptr<Tile> b) {return a->fCost() > b->fCost() || a->fCost() == b->fCost() && a->hCost > b->hCost; };
-		std::priority_queue<std::shared_ptr<Tile>, std::vector<std::shared_ptr<Tile>>, decltype(compare)> q(compare);
-		std::unordered_map<int, std::unordered_map<int, std::shared_ptr<Tile>>> visited;
-		auto startTile = std::make_shared<Tile>(m_startTile, 0, heuristic(m_startTile, m_finishTile), nullptr);
-		visited[m_startTile.x][m_startTile.y] = startTile;
-		q.push(startTile);
+		if (m_pathShown)
+			for (auto id : m_result.path) setOverlay(id, PathOverlay, false);
 
-		while (!q.empty()) {
-			auto current = q.top();
-			q.pop();
+		m_pathShown = false;
+	}
 
-			if (current->position == m_finishTile) {
-				std::vector<sf::Vector2i> path{};
-				std::shared_ptr<Tile> parent{};
+	void Grid::animatePath()
+	{
+		const std::size_t steps = traceView().steps;
 
-				// While we have parents
-				while (parent = current->parent, parent) {
-					path.push_back(parent->position);
-					current = parent;
-				}
+		// If the search and its animation finished, update ui button. Live replanning keeps the process running until the user stops it
+		if (!m_searching && !m_livePlanning && ui::inProcess && m_revealed == steps) {
+			ui::setProcessState(false);
+		}
+
+		// Reveal as many tiles as the speed allows for the time since the last frame, revealed tiles stay in the tile buffers
+		if (m_revealed < steps && !m_paused) {
+			m_revealBudget += engine::window::frameTime * engine::window::animationSpeed;
 
-				// Remove start tile from list
-				path.pop_back();
+			std::size_t count = std::min(static_cast<std::size_t>(m_revealBudget), steps - m_revealed);
+			m_revealBudget -= count;
 
-				// Reverse path to right way
-				std::reverse(path.begin(), path.end());
+			if (count > 0) {
+				revealTo(m_revealed + count);
 
-				return path;
+				// Play beep sound from 0.1 to 4 pitch, once per frame however many tiles were revealed
+				engine::audio::playSound(0.1f + (static_cast<float>(m_revealed) / steps * 4.0f));
 			}
+		}
+		// Don't save up time while waiting for the search
+		else m_revealBudget = 0;
 
-			if (m_tiles[current->position.x][current->position.y] != 'S') m_checkedTiles.push_back(current->position);
+		// Show the path once all checked tiles are drawn
+		if (!m_pathShown && !m_result.path.empty() && m_revealed == steps) {
+			for (auto id : m_result.path) setOverlay(id, PathOverlay, true);
+			m_pathShown = true;
+		}
 
-			for (int i{}; i < settings::rowDirections.size(); i++)
-			{
-				int newRow = current->position.x + settings::rowDirections[i];
-				int newCol = current->position.y + settings::colDirections[i];
+		ui::updateTimeline(m_revealed, steps);
+	}
 
-				if (!isValidTile(sf::Vector2i{ newRow, newCol })) continue;
+	void Grid::revealTo(std::size_t step)
+	{
+		auto trace = traceView();
 
-				bool tileVisited = isVisited(sf::Vector2i{ newRow, newCol }, visited);
+		if (step < m_revealed) {
+			// Going back hides the path and everything checked after the new position
+			hidePath();
 
-				if (!tileVisited || current->gCost + 1 < visited[newRow][newCol]->gCost) {
-					auto newTile = std::make_shared<Tile>(sf::Vector2i{newRow, newCol}, current->gCost + 1, heuristic({newRow, newCol}, m_finishTile), current);
-					visited[newRow][newCol] = current;
-					q.push(newTile);
-				}
-			}
+			m_cursor.seek(trace, step);
+			for (std::size_t i{ step }; i < m_revealed; i++) setOverlay(m_cursor.next(trace), CheckedOverlay, false);
+			m_cursor.seek(trace, step);
+		}
+		else {
+			m_cursor.seek(trace, m_revealed);
+			for (std::size_t i{ m_revealed }; i < step; i++) setOverlay(m_cursor.next(trace), CheckedOverlay, true);
 		}
 
-		return {};
+		m_revealed = step;
+	}
+
+	void Grid::skipAnimation()
+	{
+		// Tiles a running search checks from now on are shown when it finishes, so the worker stops handing them over
+		m_skipAnimation = true;
+		m_control.setPublishing(false);
+		m_paused = false;
+		revealTo(traceView().steps);
+	}
+
+	void Grid::seek(float position)
+	{
+		// The trace is only complete once the search is done
+		if (m_searching) return;
+
+		auto step = static_cast<std::size_t>(std::llround(engine::utils::clamp(position, 0.f, 1.f) * traceView().steps));
+		if (step == m_revealed) return;
+
+		// Hold the animation where the user left it
+		m_paused = true;
+		m_revealBudget = 0;
+		revealTo(step);
+	}
+
+	bool Grid::saveTrace(const std::string& path) const
+	{
+		if (m_searching || traceView().steps == 0) return false;
+
+		return pathfinding::writeTrace(path, m_searchMap, traceView(), m_result.path);
+	}
+
+	bool Grid::loadTrace(const std::string& path)
+	{
+		pathfinding::MappedTrace replay{};
+
+		if (!replay.open(path)) return false;
+
+		// Replaces the map and clears any current search or replay
+		setMap(replay.map());
+
+		m_replay = std::move(replay);
+		m_result.path = m_replay.path();
+		m_result.found = !m_result.path.empty();
+
+		ui::setProcessState(true);
+		return true;
+	}
+
+	void Grid::drawHover()
+	{
+		if (!isMouseOverGrid()) return;
+
+		auto tile = getTileUnderMouse();
+		auto id = m_map.id(tile);
+
+		// Only plain open tiles change colour under the mouse
+		if (id == m_map.startId() || id == m_map.finishId() || !m_map.isWalkable(id) || m_overlay[id] != NoOverlay) return;
+
+		// The hover colour is translucent, so it needs the grid background under it like the other tiles
+		m_hoverTile.setPosition(getTilePosition(tile.row, tile.column));
+		m_hoverTile.setFillColor(sf::Color::Black);
+		engine::window::windowPtr->draw(m_hoverTile);
+
+		m_hoverTile.setFillColor(settings::tileHoveredColor);
+		engine::window::windowPtr->draw(m_hoverTile);
 	}
 
 	void Grid::render()
 	{
 		// Render grid
 		engine::window::windowPtr->draw(m_gridRec);
+		engine::window::windowPtr->setView(m_camera);
 
-		// Render tiles
-		sf::RectangleShape tile{};
-
-		tile.setSize({ m_tileSize.x - settings::gridGap,
-			m_tileSize.y - settings::gridGap });
+		// Start and finish only move while being dragged
+		if (m_shownStart != m_map.startId() || m_shownFinish != m_map.finishId()) {
+			auto oldStart = m_shownStart;
+			auto oldFinish = m_shownFinish;
 
+			m_shownStart = m_map.startId();
+			m_shownFinish = m_map.finishId();
 
-		for (int row{}; row < m_rows; row++) {
-			for (int column{}; column < m_columns; column++) {
+			for (auto id : { oldStart, oldFinish, m_shownStart, m_shownFinish }) refreshTile(id);
+		}
 
-				sf::Vector2i currentTile{row, column};
+		{
+			PROFILE_SCOPE("animatePath");
+			animatePath();
+		}
 
-				tile.setPosition(getTilePosition(row, column));
+		auto visible = visibleTiles();
 
-				sf::Color tileColor{};
+		if (isDetailed()) {
+			PROFILE_SCOPE("drawTiles");
 
-				switch (m_tiles[row][column]) {
-				case '1':
-					if (isMouseOverGrid() && getTileUnderMouse() == currentTile) tileColor = settings::tileHoveredColor;
-					else tileColor = settings::tileColor;
-					break;
-				case '0':
-					tileColor = settings::tileObstacleColor;
-					break;
-				case 'S':
-					tileColor = settings::startTileColor;
-					break;
-				case 'F':
-					tileColor = settings::finishTileColor;
-					break;
-				}
+			if (m_rebuildTiles || visible != m_visibleTiles) buildTiles(visible);
+			uploadTiles();
 
-				tile.setFillColor(tileColor);
-				engine::window::windowPtr->draw(tile);
-			}
-		}
+			// Render tiles
+			if (m_useBuffer) engine::window::windowPtr->draw(m_tileBuffer, 0, m_vertices.size());
+			else engine::window::windowPtr->draw(m_vertices.data(), m_vertices.size(), sf::Triangles);
 
-		// Draw path
-		drawPath(tile);
+			// Don't let texel patches pile up while the textures aren't drawn
+			if (m_dirtyTexels.size() > maxTexelUpdates) markDirtyPages();
 
-		// If we are dragging a start or finish tile, draw their temporary position on top of the other tiles.
-		if (m_draggingStart) {
-			tile.setPosition(getTilePosition(m_startTile.x, m_startTile.y));
-			tile.setFillColor(settings::startTileColor);
-			engine::window::windowPtr->draw(tile);
+			drawHover();
 		}
+		else {
+			PROFILE_SCOPE("drawPages");
 
-		if (m_draggingFinish) {
-			tile.setPosition(getTilePosition(m_finishTile.x, m_finishTile.y));
-			tile.setFillColor(settings::finishTileColor);
-			engine::window::windowPtr->draw(tile);
+			uploadPages();
+			drawPages(visible);
 		}
+
+		engine::window::windowPtr->setView(engine::window::windowPtr->getDefaultView());
 	}
+
 	void Grid::update()
 	{
+		collectSearch();
+
+		// Keep the world point grabbed when panning started under the mouse
+		if (m_panning) {
+			sf::Vector2f mousePos = engine::window::windowPtr->mapPixelToCoords(engine::window::mousePos, m_camera);
+
+			if (mousePos != m_panAnchor) {
+				m_camera.move(m_panAnchor - mousePos);
+				clampCamera();
+			}
+		}
+
 		if (isMouseOverGrid()) {
 			auto tile = getTileUnderMouse();
-			char tileValue = m_tiles[tile.x][tile.y];
+			bool isStart = tile == m_map.start();
+			bool isFinish = tile == m_map.finish();
+
+			// Start and finish tiles can't become obstacles or share a tile
+			if (isStart || isFinish) return;
+
+			// The worker searches its own copy of the map, so edits don't have to wait for it
+			if (m_draggingStart) m_map.setStart(tile);
+
+			else if (m_draggingFinish) m_map.setFinish(tile);
 
-			if (m_draggingStart && tileValue != 'F') {
-				m_startTile = tile;
+			// Paint with the brush, an obstacle or terrain of its cost
+			else if (m_adding && m_map.cost(m_map.id(tile)) != brushCost()) {
+				m_map.setCost(tile, brushCost());
+				refreshTile(m_map.id(tile));
 			}
 
-			if (m_draggingFinish && tileValue != 'S') {
-				m_finishTile = tile;
+			// Back to plain ground
+			else if (m_removing && m_map.cost(m_map.id(tile)) != 1) {
+				m_map.setCost(tile, 1);
+				refreshTile(m_map.id(tile));
 			}
 
-			// Add obstacle
-			else if (m_adding && tileValue == '1') {
-				m_tiles[tile.x][tile.y] = '0';
+			else return;
+
+			if (m_livePlanning) replan();
+		}
+	}
+
+	void Grid::replan()
+	{
+		// Let the running search finish, it's repaired with every edit since once it's done
+		if (m_searching) {
+			m_replanPending = true;
+			return;
+		}
+
+		// Keep showing the old path until the new one is ready, only the repair is shown so skip the animation
+		m_skipAnimation = true;
+		startSearch(pathfinding::Incremental);
+	}
+
+	void Grid::startSearch(PathfindingMethod method)
+	{
+		stopSearch();
+
+		m_control.reset();
+		// Skipped searches are only read once they're done, from the result
+		m_control.setPublishing(!m_skipAnimation);
+		m_workerDone = false;
+		m_searching = true;
+		m_method = method;
+
+		// Bring the worker's map up to date, only the chunks edited since its last search are written
+		auto snapshot = m_history.snapshot(m_map);
+		snapshot->restore(m_searchMap, *m_searched);
+		m_searched = std::move(snapshot);
+
+		m_worker = std::thread{ [this, method] {
+			m_pathfinder.findPath(m_searchMap, method, m_workerResult, &m_control);
+			m_workerDone = true;
+		} };
+	}
+
+	void Grid::stopSearch()
+	{
+		if (!m_worker.joinable()) return;
+
+		m_control.cancel();
+		m_worker.join();
+		m_searching = false;
+	}
+
+	void Grid::collectSearch()
+	{
+		if (!m_searching) return;
+
+		PROFILE_SCOPE("collectSearch");
+
+		if (m_workerDone) {
+			m_worker.join();
+			m_searching = false;
+
+			// The previous result is still on screen when replanning
+			if (m_skipAnimation) {
+				clearOverlay();
+				m_trace.clear();
 			}
 
-			// Remove obstacle
-			else if (m_removing && tileValue == '0')
-				m_tiles[tile.x][tile.y] = '1';
+			// Swap to keep both buffers allocated
+			std::swap(m_result, m_workerResult);
+
+			// Record the tiles that weren't published yet, the trace is then the only copy
+			m_trace.append(m_result.checked.data() + m_trace.steps(), m_result.checked.size() - m_trace.steps());
+			m_result.checked.clear();
+			m_result.checked.shrink_to_fit();
+
+			if (m_skipAnimation) revealTo(m_trace.steps());
+
+			m_statsHistory.push_back(pathfinding::makeRecord(m_searchMap, m_method, m_result));
+			ui::showStats(m_statsHistory.back(), m_statsHistory.size());
+
+			if (m_replanPending) {
+				m_replanPending = false;
+				replan();
+			}
+		}
+
+		// Hand the renderer what the worker has checked so far
+		else if (!m_skipAnimation) {
+			m_control.take(m_published);
+			m_trace.append(m_published.data(), m_published.size());
+			m_published.clear();
 		}
 	}
 
@@ -347,28 +744,40 @@ namespace engine {
 	{
 		clearPath();
 
-		std::vector<sf::Vector2i> path{};
+		// The incremental planner keeps following edits until the search is stopped
+		m_livePlanning = method == pathfinding::Incremental;
+		m_skipAnimation = false;
+		m_paused = false;
 
-		switch (method)
-		{
-		case BreadthFirst:
-			path = breadthFirstSearch();
-			break;
-		case AStar:
-			path = aStarSearch();
-			break;
-		default:
-			break;
-		}
+		startSearch(method);
+	}
 
-		m_path = path;
+	void Grid::setMovement(pathfinding::Movement movement)
+	{
+		ui::setProcessState(false);
+		clearPath();
+
+		m_pathfinder.setMovement(movement);
+	}
+
+	bool Grid::exportStats(const std::string& path) const
+	{
+		bool json = path.size() > 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+
+		return json ? pathfinding::writeStatsJson(path, m_statsHistory) : pathfinding::writeStatsCsv(path, m_statsHistory);
 	}
 
 	void Grid::clearPath()
 	{
-		m_path.clear();
-		m_checkedTiles.clear();
-		m_checkedTilesAnimation.clear();
+		stopSearch();
+
+		m_livePlanning = false;
+		m_replanPending = false;
+		clearOverlay();
+		m_result.clear();
+		m_trace.clear();
+		m_replay.close();
+		m_paused = false;
 	}
 
 	void Grid::clearGrid()
@@ -376,13 +785,9 @@ namespace engine {
 		ui::setProcessState(false);
 		clearPath();
 
-		for (int x{}; x < m_rows; x++) {
-			for (int y{}; y < m_columns; y++) {
-				if (m_tiles[x][y] != 'S' && m_tiles[x][y] != 'F') {
-					m_tiles[x][y] = '1';
-				}
-			}
-		}
+		m_map.clear();
+		m_history.commit(m_map);
+		resetTiles();
 	}
 
 	void Grid::fillGrid()
@@ -390,53 +795,73 @@ namespace engine {
 		ui::setProcessState(false);
 		clearPath();
 
-		for (int x{}; x < m_rows; x++) {
-			for (int y{}; y < m_columns; y++) {
-				if (m_tiles[x][y] != 'S' && m_tiles[x][y] != 'F') {
-					m_tiles[x][y] = '0';
-				}
-			}
-		}
-
+		m_map.fill();
+		m_history.commit(m_map);
+		resetTiles();
 	}
 
 	void Grid::randomGrid()
 	{
 		ui::setProcessState(false);
-		clearGrid();
+		clearPath();
 
-		// Get random coverage
-		int coverage = rand() % settings::randomGridMaxCoverage + 1;
+		m_map.randomize(settings::randomGridMaxCoverage);
+		m_history.commit(m_map);
+		resetTiles();
+	}
 
-		for (int x{}; x < m_rows; x++) {
-			for (int y{}; y < m_columns; y++) {
-				if (m_tiles[x][y] != 'S' && m_tiles[x][y] != 'F' && rand() % 100 + 1 < coverage) {
-					m_tiles[x][y] = '0';
-				}
-			}
+	bool Grid::undo()
+	{
+		// Not halfway through a stroke
+		if (m_adding || m_removing || m_draggingStart || m_draggingFinish || !m_history.canUndo()) return false;
+
+		stepHistory(true);
+		return true;
+	}
+
+	bool Grid::redo()
+	{
+		if (m_adding || m_removing || m_draggingStart || m_draggingFinish || !m_history.canRedo()) return false;
+
+		stepHistory(false);
+		return true;
+	}
+
+	void Grid::stepHistory(bool back)
+	{
+		// Like any other edit, the search is replanned while live planning and cleared otherwise
+		if (!m_livePlanning) {
+			ui::setProcessState(false);
+			clearPath();
 		}
+
+		std::uint64_t revision = m_map.revision();
+
+		if (back) m_history.undo(m_map);
+		else m_history.redo(m_map);
+
+		showEdits(revision);
+
+		if (m_livePlanning) replan();
 	}
 
 	void Grid::leftClick(sf::Vector2i& mousePos)
 	{
 		if (!m_removing && isMouseOverGrid()) {
 
-			clearPath();
-			ui::setProcessState(false);
+			if (!m_livePlanning) {
+				clearPath();
+				ui::setProcessState(false);
+			}
 			auto tile = getTileUnderMouse();
-			char tileValue = m_tiles[tile.x][tile.y];
 
 			// Start dragging of start tile
-			if (tileValue == 'S') {
-				m_tiles[m_startTile.x][m_startTile.y] = '1';
+			if (tile == m_map.start()) {
 				m_draggingStart = true;
 			}
 
 			// Start dragging of finish tile
-			else if (tileValue == 'F') {
-				clearPath();
-				ui::setProcessState(false);
-				m_tiles[m_finishTile.x][m_finishTile.y] = '1';
+			else if (tile == m_map.finish()) {
 				m_draggingFinish = true;
 			}
 			// Start adding obstacles
@@ -445,24 +870,62 @@ namespace engine {
 	}
 	void Grid::leftReleased(sf::Vector2i& mousePos)
 	{
-		if (m_draggingStart) m_tiles[m_startTile.x][m_startTile.y] = 'S';
-		if (m_draggingFinish) m_tiles[m_finishTile.x][m_finishTile.y] = 'F';
+		// Dropping start or finish onto an obstacle clears it
+		if (m_draggingStart || m_draggingFinish) {
+			m_map.setWalkable(m_draggingStart ? m_map.start() : m_map.finish(), true);
+			refreshTile(m_draggingStart ? m_map.startId() : m_map.finishId());
+
+			if (m_livePlanning) replan();
+		}
 
 		m_draggingStart = false;
 		m_draggingFinish = false;
 		m_adding = false;
+
+		// The stroke or drag is one step to undo
+		m_history.commit(m_map);
 	}
 	void Grid::rightClick()
 	{
 		if (!m_adding && isMouseOverGrid()) {
 
-			clearPath();
-			ui::setProcessState(false);
+			if (!m_livePlanning) {
+				clearPath();
+				ui::setProcessState(false);
+			}
 			m_removing = true;
 		}
 	}
 	void Grid::rightReleased()
 	{
 		m_removing = false;
+		m_history.commit(m_map);
+	}
+	void Grid::zoom(float delta, const sf::Vector2i& mousePos)
+	{
+		if (!isMouseOverGrid()) return;
+
+		sf::Vector2f before = engine::window::windowPtr->mapPixelToCoords(mousePos, m_camera);
+
+		m_camera.zoom(std::pow(settings::zoomStep, -delta));
+		clampCamera();
+
+		// Move the camera so the point under the mouse stays there
+		m_camera.move(before - engine::window::windowPtr->mapPixelToCoords(mousePos, m_camera));
+		clampCamera();
+
+		// Tile gaps depend on the zoom
+		m_rebuildTiles = true;
+	}
+	void Grid::middleClick(const sf::Vector2i& mousePos)
+	{
+		if (!isMouseOverGrid()) return;
+
+		m_panning = true;
+		m_panAnchor = engine::window::windowPtr->mapPixelToCoords(mousePos, m_camera);
+	}
+	void Grid::middleReleased()
+	{
+		m_panning = false;
 	}
 }
@@ -3,20 +3,38 @@
 #include "../include/ui.h"
 #include "../include/grid.h"
 #include "../include/audio.h"
+#include "../include/profiler.h"
 
 void handleEvents() {
-    engine::window::update();
-    engine::grid.update();
+    {
+        PROFILE_SCOPE("window::update");
+        engine::window::update();
+    }
+    {
+        PROFILE_SCOPE("grid.update");
+        engine::grid.update();
+    }
 }
 
 void draw() {
     engine::window::startDrawing();
-    engine::ui::render();
-    engine::grid.render();
-    engine::window::endDrawing();
+    {
+        PROFILE_SCOPE("ui::render");
+        engine::ui::render();
+    }
+    {
+        PROFILE_SCOPE("grid.render");
+        engine::grid.render();
+    }
+    engine::profiler::render();
+    {
+        // Includes waiting for the frame rate limit
+        PROFILE_SCOPE("display");
+        engine::window::endDrawing();
+    }
 }
 
-int main()
+int main(int argc, char** argv)
 {
     srand(time(NULL));
 
@@ -24,9 +42,23 @@ int main()
 
     engine::ui::initialize();
     engine::audio::initialize();
+    engine::profiler::initialize();
+
+    // Optional MovingAI .map file to open instead of the default grid, a .trace file to replay or a .chunks map
+    if (argc > 1) {
+        std::string path{ argv[1] };
+        auto hasExtension = [&](const std::string& extension) {
+            return path.size() > extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+        };
+
+        if (hasExtension(".trace")) engine::grid.loadTrace(path);
+        else if (hasExtension(".chunks")) engine::grid.loadChunkedMap(path);
+        else engine::grid.loadMap(path);
+    }
 
     while (engine::window::windowPtr->isOpen())
     {
+        PROFILE_FRAME();
         handleEvents();
         draw();
     }
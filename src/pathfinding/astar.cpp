@@ -0,0 +1,145 @@
+#include "../../include/pathfinding/astar.h"
+#include "../../include/pathfinding/path.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		template <typename OpenList>
+		void BasicAStarEngine<OpenList>::search(const Map& map, Position startTile, Position finishTile, SearchResult& result, SearchControl* control, Movement movement)
+		{
+			const TileId start = map.id(startTile);
+			const TileId finish = map.id(finishTile);
+
+			// Pick the instantiation once, the expansion loop never looks at movement
+			switch (movement)
+			{
+			case Movement::EightConnected:
+				search<EightConnected<CornerRule::Cut>, OctileDistance>(map, start, finish, result, control);
+				break;
+			case Movement::EightConnectedNoSqueezing:
+				search<EightConnected<CornerRule::NoSqueezing>, OctileDistance>(map, start, finish, result, control);
+				break;
+			case Movement::EightConnectedNoCutting:
+				search<EightConnected<CornerRule::NoCutting>, OctileDistance>(map, start, finish, result, control);
+				break;
+			default:
+				search<FourConnected, ManhattanDistance>(map, start, finish, result, control);
+				break;
+			}
+		}
+
+		template <typename OpenList>
+		template <typename Neighbourhood, typename Distance>
+		void BasicAStarEngine<OpenList>::search(const Map& map, TileId start, TileId finish, SearchResult& result, SearchControl* control)
+		{
+			// Work in padded coordinates, the heuristic only needs differences
+			const int finishRow = static_cast<int>(finish / map.stride());
+			const int finishColumn = static_cast<int>(finish % map.stride());
+
+			search<Neighbourhood>(map, start, finish, result, control, [=](TileId, int row, int column) {
+				return Distance::template estimate<Neighbourhood>(row - finishRow, column - finishColumn);
+			});
+		}
+
+		template <typename OpenList>
+		void BasicAStarEngine<OpenList>::search(const Map& map, Position startTile, Position finishTile, const LandmarkTable& landmarks, SearchResult& result, SearchControl* control)
+		{
+			const TileId finish = map.id(finishTile);
+			const int finishRow = static_cast<int>(finish / map.stride());
+			const int finishColumn = static_cast<int>(finish % map.stride());
+			const std::uint16_t* target = landmarks.distances(finish);
+
+			search<FourConnected>(map, map.id(startTile), finish, result, control, [=, &landmarks](TileId tile, int row, int column) {
+				std::uint32_t manhattan = abs(row - finishRow) + abs(column - finishColumn);
+				return std::max(manhattan, landmarks.lowerBound(landmarks.distances(tile), target));
+			});
+		}
+
+		template <typename OpenList>
+		template <typename Neighbourhood, typename Heuristic>
+		void BasicAStarEngine<OpenList>::search(const Map& map, TileId start, TileId finish, SearchResult& result, SearchControl* control, const Heuristic& heuristic)
+		{
+			result.clear();
+
+			const std::uint8_t* cells = map.cells();
+			const int stride = map.stride();
+
+			m_state.prepare(map.size());
+			if (m_gCost.size() != map.size()) {
+				m_gCost.resize(map.size());
+				m_parent.resize(map.size());
+			}
+
+			m_open.clear();
+			if constexpr (OpenList::decreaseKey) m_open.prepare(map.size());
+
+			std::uint32_t startH = heuristic(start, static_cast<int>(start / stride), static_cast<int>(start % stride));
+			m_state.open(start);
+			m_gCost[start] = 0;
+			m_parent[start] = start;
+			m_open.push({ startH, startH, start });
+			result.stats.pushed = 1;
+
+			while (!m_open.empty()) {
+				OpenNode current = m_open.pop();
+
+				// A better copy of this tile was already expanded
+				if (m_state.isClosed(current.tile)) {
+					result.stats.stalePops++;
+					continue;
+				}
+				m_state.close(current.tile);
+
+				if (current.tile == finish) {
+					reconstructPath(m_parent, start, finish, result.path);
+					// Fixed point costs would round, count the moves instead
+					result.cost = Neighbourhood::diagonal ? octileLength(start, result.path, finish, stride) : m_gCost[finish];
+					result.found = true;
+					return;
+				}
+
+				if (current.tile != start) result.checked.push_back(current.tile);
+				if (!keepSearching(control, result.checked)) return;
+
+				result.stats.expanded++;
+
+				const int row = static_cast<int>(current.tile / stride);
+				const int column = static_cast<int>(current.tile % stride);
+				const std::uint32_t currentCost = m_gCost[current.tile];
+
+				Neighbourhood::forEach(cells, current.tile, stride, [&](TileId next, int rowStep, int columnStep, std::uint32_t stepCost) {
+					const std::uint32_t gCost = currentCost + stepCost;
+					const bool seen = m_state.isSeen(next);
+
+					if (seen) {
+						if (m_state.isClosed(next) || gCost >= m_gCost[next]) return;
+					}
+					else m_state.open(next);
+
+					m_gCost[next] = gCost;
+					m_parent[next] = current.tile;
+
+					std::uint32_t hCost = heuristic(next, row + rowStep, column + columnStep);
+
+					// Seen and not closed means the tile is still in the list
+					if constexpr (OpenList::decreaseKey) {
+						if (seen) {
+							m_open.decrease({ gCost + hCost, hCost, next });
+							return;
+						}
+					}
+
+					m_open.push({ gCost + hCost, hCost, next });
+					result.stats.pushed++;
+				});
+
+				result.stats.peakOpen = std::max<std::uint64_t>(result.stats.peakOpen, m_open.size());
+			}
+		}
+
+		template class BasicAStarEngine<BinaryHeapOpenList>;
+		template class BasicAStarEngine<QuaternaryHeapOpenList>;
+		template class BasicAStarEngine<PairingHeapOpenList>;
+		template class BasicAStarEngine<BucketOpenList>;
+	}
+}
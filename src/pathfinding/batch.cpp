@@ -0,0 +1,44 @@
+#include "../../include/pathfinding/batch.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		BatchSolver::BatchSolver(std::size_t threads) : m_pool{ threads }
+		{
+			for (std::size_t i{}; i < m_pool.size(); i++) {
+				m_workers.push_back(std::make_unique<Worker>());
+				// The batch already keeps every thread busy, a parallel search would start a pool per worker
+				m_workers.back()->pathfinder.setSearchThreads(1);
+			}
+		}
+
+		void BatchSolver::setLandmarkCount(std::size_t count)
+		{
+			for (auto& worker : m_workers) worker->pathfinder.setLandmarkCount(count);
+		}
+
+		void BatchSolver::setOpenList(OpenListKind kind)
+		{
+			for (auto& worker : m_workers) worker->pathfinder.setOpenList(kind);
+		}
+
+		void BatchSolver::solve(const Map& map, const std::vector<PathQuery>& queries, std::vector<SearchResult>& results)
+		{
+			// Keep the old results around, their vectors are reused
+			results.resize(queries.size());
+
+			m_pool.run(queries.size(), [&](std::size_t index, std::size_t query) {
+				Worker& worker = *m_workers[index];
+				const PathQuery& request = queries[query];
+				SearchResult& result = results[query];
+
+				if (!map.isInside(request.start) || !map.isInside(request.finish)) {
+					result.clear();
+					return;
+				}
+
+				worker.pathfinder.findPath(map, request.start, request.finish, request.method, result);
+			});
+		}
+	}
+}
@@ -0,0 +1,58 @@
+#include "../../include/pathfinding/bfs.h"
+#include "../../include/pathfinding/path.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		void BreadthFirstEngine::search(const Map& map, Position startTile, Position finishTile, SearchResult& result, SearchControl* control)
+		{
+			result.clear();
+
+			const TileId start = map.id(startTile);
+			const TileId finish = map.id(finishTile);
+			const auto offsets = map.neighbourOffsets();
+			const std::uint8_t* cells = map.cells();
+
+			m_visited.prepare(map.size());
+			if (m_parent.size() != map.size()) m_parent.resize(map.size());
+
+			// Every tile is queued at most once, so a plain array with a read index is enough
+			m_queue.clear();
+			m_queue.push_back(start);
+			m_visited.open(start);
+			m_parent[start] = start;
+			result.stats.pushed = 1;
+
+			for (std::size_t head{}; head < m_queue.size(); head++) {
+
+				TileId current = m_queue[head];
+
+				if (current == finish) {
+					reconstructPath(m_parent, start, finish, result.path);
+					result.cost = start == finish ? 0 : result.path.size() + 1.0;
+					result.found = true;
+					return;
+				}
+
+				if (current != start) result.checked.push_back(current);
+				if (!keepSearching(control, result.checked)) return;
+
+				result.stats.expanded++;
+				result.stats.peakOpen = std::max<std::uint64_t>(result.stats.peakOpen, m_queue.size() - head);
+
+				// Explore the neighboring cells
+				for (auto offset : offsets)
+				{
+					TileId next = static_cast<TileId>(current + offset);
+
+					if (cells[next] && !m_visited.isSeen(next)) {
+						m_visited.open(next);
+						m_parent[next] = current;
+						m_queue.push_back(next);
+						result.stats.pushed++;
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,258 @@
+#include "../../include/pathfinding/bidirectional.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		namespace {
+
+			// Row and column steps matching Map::neighbourOffsets
+			constexpr std::array<int, 4> rowSteps{ 0, 0, -1, 1 };
+			constexpr std::array<int, 4> columnSteps{ -1, 1, 0, 0 };
+
+			constexpr std::uint32_t unreachable{ ~std::uint32_t{} };
+
+			/*
+				Join the forward parents up to meetForward with the backward parents from
+				the adjacent meetBackward, leaving out the start and finish tiles.
+			*/
+			void joinPaths(const std::vector<TileId>& forwardParent, const std::vector<TileId>& backwardParent,
+				TileId start, TileId finish, TileId meetForward, TileId meetBackward, std::vector<TileId>& path)
+			{
+				path.clear();
+
+				for (TileId tile = meetForward; tile != start; tile = forwardParent[tile]) path.push_back(tile);
+				std::reverse(path.begin(), path.end());
+
+				for (TileId tile = meetBackward; tile != finish; tile = backwardParent[tile]) path.push_back(tile);
+			}
+		}
+
+		std::size_t BidirectionalBreadthFirstEngine::memoryUsage() const
+		{
+			std::size_t bytes{};
+
+			for (const Side* side : { &m_forward, &m_backward })
+				bytes += side->seen.memoryUsage() + capacityBytes(side->distance) + capacityBytes(side->parent) + capacityBytes(side->queue);
+
+			return bytes;
+		}
+
+		void BidirectionalBreadthFirstEngine::search(const Map& map, Position startTile, Position finishTile, SearchResult& result, SearchControl* control)
+		{
+			result.clear();
+
+			const TileId start = map.id(startTile);
+			const TileId finish = map.id(finishTile);
+			const auto offsets = map.neighbourOffsets();
+			const std::uint8_t* cells = map.cells();
+
+			if (start == finish) {
+				result.found = true;
+				return;
+			}
+
+			// The backward side would happily leave a blocked finish
+			if (!cells[finish]) return;
+
+			for (auto* side : { &m_forward, &m_backward }) {
+				side->seen.prepare(map.size());
+				if (side->distance.size() != map.size()) {
+					side->distance.resize(map.size());
+					side->parent.resize(map.size());
+				}
+				side->queue.clear();
+				side->head = 0;
+			}
+
+			auto begin = [](Side& side, TileId origin) {
+				side.seen.open(origin);
+				side.distance[origin] = 0;
+				side.parent[origin] = origin;
+				side.queue.push_back(origin);
+			};
+
+			result.stats.pushed = 2;
+
+			begin(m_forward, start);
+			begin(m_backward, finish);
+
+			std::uint32_t best{ unreachable };
+			TileId meetForward{ invalidTile };
+			TileId meetBackward{ invalidTile };
+
+			while (m_forward.head < m_forward.queue.size() && m_backward.head < m_backward.queue.size()) {
+				bool forward = m_forward.queue.size() - m_forward.head <= m_backward.queue.size() - m_backward.head;
+				Side& side = forward ? m_forward : m_backward;
+				Side& other = forward ? m_backward : m_forward;
+
+				// Expand one whole level
+				std::size_t levelEnd = side.queue.size();
+
+				for (; side.head < levelEnd; side.head++) {
+					TileId current = side.queue[side.head];
+
+					if (current != start && current != finish) result.checked.push_back(current);
+					if (!keepSearching(control, result.checked)) return;
+
+					result.stats.expanded++;
+
+					for (auto offset : offsets)
+					{
+						TileId next = static_cast<TileId>(current + offset);
+
+						if (!cells[next]) continue;
+
+						if (other.seen.isSeen(next)) {
+							std::uint32_t length = side.distance[current] + 1 + other.distance[next];
+
+							if (length < best) {
+								best = length;
+								meetForward = forward ? current : next;
+								meetBackward = forward ? next : current;
+							}
+						}
+
+						if (!side.seen.isSeen(next)) {
+							side.seen.open(next);
+							side.distance[next] = side.distance[current] + 1;
+							side.parent[next] = current;
+							side.queue.push_back(next);
+							result.stats.pushed++;
+						}
+					}
+				}
+
+				std::uint64_t frontier = (m_forward.queue.size() - m_forward.head) + (m_backward.queue.size() - m_backward.head);
+				result.stats.peakOpen = std::max(result.stats.peakOpen, frontier);
+
+				// Every remaining connection is at least as long as the best one from this level
+				if (best != unreachable) {
+					joinPaths(m_forward.parent, m_backward.parent, start, finish, meetForward, meetBackward, result.path);
+					result.cost = best;
+					result.found = true;
+					return;
+				}
+			}
+		}
+
+		std::size_t BidirectionalAStarEngine::memoryUsage() const
+		{
+			std::size_t bytes{};
+
+			for (const Side* side : { &m_forward, &m_backward })
+				bytes += side->state.memoryUsage() + capacityBytes(side->gCost) + capacityBytes(side->parent) + side->open.memoryUsage();
+
+			return bytes;
+		}
+
+		void BidirectionalAStarEngine::search(const Map& map, Position startTile, Position finishTile, SearchResult& result, SearchControl* control)
+		{
+			result.clear();
+
+			const TileId start = map.id(startTile);
+			const TileId finish = map.id(finishTile);
+			const auto offsets = map.neighbourOffsets();
+			const std::uint8_t* cells = map.cells();
+			const int stride = map.stride();
+
+			if (start == finish) {
+				result.found = true;
+				return;
+			}
+
+			// The backward side would happily leave a blocked finish
+			if (!cells[finish]) return;
+
+			auto heuristic = [](const Side& side, int row, int column) {
+				return static_cast<std::uint32_t>(abs(row - side.targetRow) + abs(column - side.targetColumn));
+			};
+
+			auto begin = [&](Side& side, TileId origin, TileId target) {
+				side.state.prepare(map.size());
+				if (side.gCost.size() != map.size()) {
+					side.gCost.resize(map.size());
+					side.parent.resize(map.size());
+				}
+				side.open.clear();
+
+				side.targetRow = static_cast<int>(target / stride);
+				side.targetColumn = static_cast<int>(target % stride);
+
+				std::uint32_t hCost = heuristic(side, static_cast<int>(origin / stride), static_cast<int>(origin % stride));
+				side.state.open(origin);
+				side.gCost[origin] = 0;
+				side.parent[origin] = origin;
+				side.open.push({ hCost, hCost, origin });
+			};
+
+			begin(m_forward, start, finish);
+			begin(m_backward, finish, start);
+			result.stats.pushed = 2;
+
+			std::uint32_t best{ unreachable };
+			TileId meetForward{ invalidTile };
+			TileId meetBackward{ invalidTile };
+
+			while (!m_forward.open.empty() && !m_backward.open.empty()) {
+
+				// No unexpanded tile on either side can lead to a cheaper connection
+				if (std::max(m_forward.open.top().fCost, m_backward.open.top().fCost) >= best) break;
+
+				bool forward = m_forward.open.size() <= m_backward.open.size();
+				Side& side = forward ? m_forward : m_backward;
+				Side& other = forward ? m_backward : m_forward;
+
+				OpenNode current = side.open.pop();
+
+				// A better copy of this tile was already expanded
+				if (side.state.isClosed(current.tile)) {
+					result.stats.stalePops++;
+					continue;
+				}
+				side.state.close(current.tile);
+
+				if (current.tile != start && current.tile != finish) result.checked.push_back(current.tile);
+				if (!keepSearching(control, result.checked)) return;
+
+				result.stats.expanded++;
+
+				const int row = static_cast<int>(current.tile / stride);
+				const int column = static_cast<int>(current.tile % stride);
+				const std::uint32_t gCost = side.gCost[current.tile] + 1;
+
+				for (int i{}; i < 4; i++)
+				{
+					TileId next = static_cast<TileId>(current.tile + offsets[i]);
+
+					if (!cells[next]) continue;
+
+					if (other.state.isSeen(next) && gCost + other.gCost[next] < best) {
+						best = gCost + other.gCost[next];
+						meetForward = forward ? current.tile : next;
+						meetBackward = forward ? next : current.tile;
+					}
+
+					if (side.state.isSeen(next)) {
+						if (side.state.isClosed(next) || gCost >= side.gCost[next]) continue;
+					}
+					else side.state.open(next);
+
+					side.gCost[next] = gCost;
+					side.parent[next] = current.tile;
+
+					std::uint32_t hCost = heuristic(side, row + rowSteps[i], column + columnSteps[i]);
+					side.open.push({ gCost + hCost, hCost, next });
+					result.stats.pushed++;
+				}
+
+				result.stats.peakOpen = std::max<std::uint64_t>(result.stats.peakOpen, m_forward.open.size() + m_backward.open.size());
+			}
+
+			if (best != unreachable) {
+				joinPaths(m_forward.parent, m_backward.parent, start, finish, meetForward, meetBackward, result.path);
+				result.cost = best;
+				result.found = true;
+			}
+		}
+	}
+}
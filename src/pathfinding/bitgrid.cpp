@@ -0,0 +1,27 @@
+#include "../../include/pathfinding/bitgrid.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		void BitGrid::build(const Map& map)
+		{
+			// Reads reach a full row plus one word past either end of the map
+			std::size_t bits = map.size() + 2 * (padding + map.stride()) + 64;
+			m_words.assign((bits + 63) / 64, 0);
+
+			const std::uint8_t* cells = map.cells();
+
+			for (TileId tile{}; tile < map.size(); tile++) {
+				if (cells[tile]) m_words[wordIndex(tile)] |= std::uint64_t{ 1 } << bitIndex(tile);
+			}
+		}
+
+		void BitGrid::set(TileId tile, bool value)
+		{
+			std::uint64_t mask = std::uint64_t{ 1 } << bitIndex(tile);
+
+			if (value) m_words[wordIndex(tile)] |= mask;
+			else m_words[wordIndex(tile)] &= ~mask;
+		}
+	}
+}
@@ -0,0 +1,140 @@
+#include "../../include/pathfinding/chunked_astar.h"
+
+#include <cstring>
+
+namespace engine {
+	namespace pathfinding {
+
+		namespace {
+
+			constexpr std::uint8_t directionMask{ 3 };
+			constexpr std::uint8_t seenFlag{ 4 };
+			constexpr std::uint8_t closedFlag{ 8 };
+
+			// Left, right, up and down like Map::neighbourOffsets, and the direction back for each
+			constexpr int rowSteps[4]{ 0, 0, -1, 1 };
+			constexpr int columnSteps[4]{ -1, 1, 0, 0 };
+			constexpr std::uint8_t opposite[4]{ 1, 0, 3, 2 };
+
+			std::size_t local(Position tile)
+			{
+				constexpr int mask{ ChunkedMap::chunkSize - 1 };
+				return static_cast<std::size_t>(tile.row & mask) * ChunkedMap::chunkSize + (tile.column & mask);
+			}
+		}
+
+		std::size_t ChunkedAStarEngine::memoryUsage() const
+		{
+			// Each map entry costs about a node and a bucket
+			return m_blocks.size() * sizeof(Block) + capacityBytes(m_blocks) + capacityBytes(m_open)
+				+ m_blockOf.size() * (sizeof(std::pair<std::uint64_t, Block*>) + 2 * sizeof(void*));
+		}
+
+		ChunkedAStarEngine::Block& ChunkedAStarEngine::block(Position tile)
+		{
+			std::uint64_t index = static_cast<std::uint64_t>(static_cast<std::uint32_t>(tile.row >> ChunkedMap::chunkShift)) << 32
+				| static_cast<std::uint32_t>(tile.column >> ChunkedMap::chunkShift);
+
+			if (m_lastBlock && index == m_lastIndex) return *m_lastBlock;
+
+			auto [found, added] = m_blockOf.try_emplace(index, nullptr);
+
+			// Blocks are reused between queries, only their state has to be cleared
+			if (added) {
+				if (m_usedBlocks == m_blocks.size()) m_blocks.push_back(std::make_unique<Block>());
+
+				found->second = m_blocks[m_usedBlocks++].get();
+				std::memset(found->second->state, 0, sizeof(Block::state));
+			}
+
+			m_lastIndex = index;
+			m_lastBlock = found->second;
+			return *m_lastBlock;
+		}
+
+		void ChunkedAStarEngine::search(ChunkedMap& map, Position start, Position finish, ChunkedSearchResult& result)
+		{
+			auto begin = std::chrono::steady_clock::now();
+
+			result.clear();
+			m_blockOf.clear();
+			m_usedBlocks = 0;
+			m_lastBlock = nullptr;
+			m_open.clear();
+
+			auto isWorse = [](const Node& a, const Node& b) { return a.key > b.key; };
+
+			auto push = [&](Position tile, std::uint32_t gCost) {
+				auto hCost = static_cast<std::uint32_t>(std::abs(tile.row - finish.row) + std::abs(tile.column - finish.column));
+
+				m_open.push_back({ static_cast<std::uint64_t>(gCost + hCost) << 32 | hCost, tile });
+				std::push_heap(m_open.begin(), m_open.end(), isWorse);
+				result.stats.pushed++;
+			};
+
+			if (map.isWalkable(start) && map.isWalkable(finish)) {
+				Block& first = block(start);
+				first.gCost[local(start)] = 0;
+				first.state[local(start)] = seenFlag;
+				push(start, 0);
+			}
+
+			while (!m_open.empty()) {
+				std::pop_heap(m_open.begin(), m_open.end(), isWorse);
+				Position current = m_open.back().tile;
+				m_open.pop_back();
+
+				Block& currentBlock = block(current);
+				const std::size_t index = local(current);
+
+				// A better copy of this tile was already expanded
+				if (currentBlock.state[index] & closedFlag) {
+					result.stats.stalePops++;
+					continue;
+				}
+				currentBlock.state[index] |= closedFlag;
+
+				if (current == finish) {
+					result.cost = currentBlock.gCost[index];
+					result.found = true;
+
+					// Follow the directions back, the path excludes start and finish. The start has no direction, so it's checked first
+					for (Position tile = finish; tile != start;) {
+						std::uint8_t back = block(tile).state[local(tile)] & directionMask;
+						tile = { tile.row + rowSteps[back], tile.column + columnSteps[back] };
+
+						if (tile != start) result.path.push_back(tile);
+					}
+
+					std::reverse(result.path.begin(), result.path.end());
+					break;
+				}
+
+				result.stats.expanded++;
+
+				const std::uint32_t gCost = currentBlock.gCost[index] + 1;
+
+				for (int i{}; i < 4; i++) {
+					Position next{ current.row + rowSteps[i], current.column + columnSteps[i] };
+					if (!map.isWalkable(next)) continue;
+
+					Block& nextBlock = block(next);
+					const std::size_t nextIndex = local(next);
+
+					if (nextBlock.state[nextIndex] & seenFlag) {
+						if (nextBlock.state[nextIndex] & closedFlag || gCost >= nextBlock.gCost[nextIndex]) continue;
+					}
+
+					nextBlock.gCost[nextIndex] = gCost;
+					nextBlock.state[nextIndex] = seenFlag | opposite[i];
+					push(next, gCost);
+				}
+
+				result.stats.peakOpen = std::max<std::uint64_t>(result.stats.peakOpen, m_open.size());
+			}
+
+			result.stats.peakMemory = memoryUsage();
+			result.stats.searchSeconds = secondsSince(begin);
+		}
+	}
+}
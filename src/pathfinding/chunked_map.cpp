@@ -0,0 +1,264 @@
+#include "../../include/pathfinding/chunked_map.h"
+
+#include <cstring>
+
+namespace engine {
+	namespace pathfinding {
+
+		namespace {
+
+			constexpr char magic[4]{ 'P', 'F', 'C', 'M' };
+			constexpr std::uint32_t version{ 1 };
+
+			struct FileHeader
+			{
+				char magic[4]{};
+				std::uint32_t version{};
+				std::int32_t rows{};
+				std::int32_t columns{};
+				std::uint32_t chunkShift{};
+				std::uint32_t reserved{};
+				std::uint64_t indexOffset{};
+			};
+
+			// Chunks start after the header's page
+			constexpr std::uint64_t firstChunk{ ChunkedMap::chunkBytes };
+
+			int chunkCount(int tiles) { return (tiles + ChunkedMap::chunkSize - 1) >> ChunkedMap::chunkShift; }
+		}
+
+		bool ChunkedMap::open(const std::string& path)
+		{
+			close();
+
+			if (!m_file.open(path) || m_file.size() < firstChunk) {
+				close();
+				return false;
+			}
+
+			FileHeader header{};
+			std::memcpy(&header, m_file.data(), sizeof(header));
+
+			bool valid = std::memcmp(header.magic, magic, sizeof(magic)) == 0 && header.version == version
+				&& header.chunkShift == chunkShift
+				&& header.rows > 0 && header.rows <= maxDimension && header.columns > 0 && header.columns <= maxDimension;
+
+			// Only the index has to fit, chunk offsets are checked when a chunk is first read
+			std::uint64_t entries = valid ? static_cast<std::uint64_t>(chunkCount(header.rows)) * chunkCount(header.columns) : 0;
+			valid = valid && header.indexOffset >= firstChunk && header.indexOffset % alignof(ChunkEntry) == 0
+				&& header.indexOffset <= m_file.size() && entries <= (m_file.size() - header.indexOffset) / sizeof(ChunkEntry);
+
+			if (!valid) {
+				close();
+				return false;
+			}
+
+			m_rows = header.rows;
+			m_columns = header.columns;
+			m_chunkRows = chunkCount(m_rows);
+			m_chunkColumns = chunkCount(m_columns);
+			m_entries = reinterpret_cast<const ChunkEntry*>(m_file.data() + header.indexOffset);
+
+			return true;
+		}
+
+		void ChunkedMap::close()
+		{
+			m_file.close();
+			m_rows = 0;
+			m_columns = 0;
+			m_chunkRows = 0;
+			m_chunkColumns = 0;
+			m_entries = nullptr;
+			m_recent.clear();
+			m_resident.clear();
+			m_lastChunk = ~std::uint64_t{};
+			m_lastTiles = nullptr;
+		}
+
+		const std::uint8_t* ChunkedMap::chunk(int chunkRow, int chunkColumn)
+		{
+			if (chunkRow < 0 || chunkColumn < 0 || chunkRow >= m_chunkRows || chunkColumn >= m_chunkColumns) return uniform(0);
+
+			std::uint64_t index = static_cast<std::uint64_t>(chunkRow) * m_chunkColumns + chunkColumn;
+			if (index == m_lastChunk) return m_lastTiles;
+
+			const ChunkEntry& entry = m_entries[index];
+			const std::uint8_t* tiles{};
+
+			if (entry.offset == 0) tiles = uniform(entry.fill);
+			else if (entry.offset < firstChunk || entry.offset % chunkBytes != 0 || entry.offset > m_file.size() - chunkBytes) tiles = uniform(0);
+			else {
+				tiles = m_file.data() + entry.offset;
+				touch(index);
+			}
+
+			m_lastChunk = index;
+			m_lastTiles = tiles;
+			return tiles;
+		}
+
+		void ChunkedMap::setChunkBudget(std::size_t chunks)
+		{
+			m_budget = std::max<std::size_t>(chunks, 1);
+			trim();
+		}
+
+		void ChunkedMap::touch(std::uint64_t index)
+		{
+			auto found = m_resident.find(index);
+
+			if (found != m_resident.end()) {
+				m_recent.splice(m_recent.begin(), m_recent, found->second);
+				return;
+			}
+
+			m_recent.push_front(index);
+			m_resident.emplace(index, m_recent.begin());
+			trim();
+		}
+
+		void ChunkedMap::trim()
+		{
+			// The mapping stays valid, a dropped chunk is read from the file again when it's next touched
+			while (m_resident.size() > m_budget) {
+				std::uint64_t evicted = m_recent.back();
+				m_file.release(static_cast<std::size_t>(m_entries[evicted].offset), chunkBytes);
+				m_resident.erase(evicted);
+				m_recent.pop_back();
+			}
+		}
+
+		const std::uint8_t* ChunkedMap::uniform(std::uint8_t fill)
+		{
+			auto& tiles = m_uniform[fill];
+
+			if (!tiles) {
+				tiles = std::make_unique<std::uint8_t[]>(chunkBytes);
+				std::memset(tiles.get(), fill, chunkBytes);
+			}
+
+			return tiles.get();
+		}
+
+		void ChunkedMap::extract(Position corner, Map& map)
+		{
+			for (int row{}; row < map.rows(); row++) {
+				for (int column{}; column < map.columns(); column++) {
+					std::uint8_t cost = this->cost({ corner.row + row, corner.column + column });
+					if (cost != map.cost(map.id(row, column))) map.setCost({ row, column }, cost);
+				}
+			}
+
+			// Start and finish are always open
+			map.setWalkable(map.start(), true);
+			map.setWalkable(map.finish(), true);
+		}
+
+		ChunkedMapWriter::~ChunkedMapWriter()
+		{
+			// Closing without close() leaves an incomplete file behind
+			if (m_file) std::fclose(m_file);
+		}
+
+		bool ChunkedMapWriter::open(const std::string& path, int rows, int columns)
+		{
+			if (m_file) std::fclose(m_file);
+			m_file = nullptr;
+
+			if (rows <= 0 || columns <= 0 || rows > ChunkedMap::maxDimension || columns > ChunkedMap::maxDimension) return false;
+
+			m_file = std::fopen(path.c_str(), "wb");
+			if (!m_file) return false;
+
+			m_rows = rows;
+			m_columns = columns;
+			m_written = 0;
+			m_failed = false;
+			m_entries.clear();
+			m_entries.reserve(static_cast<std::size_t>(chunkCount(rows)) * chunkCount(columns));
+			m_chunk.resize(ChunkedMap::chunkBytes);
+
+			// The header is written last, over this page
+			std::vector<std::uint8_t> page(firstChunk);
+			m_failed = std::fwrite(page.data(), 1, page.size(), m_file) != page.size();
+			m_offset = firstChunk;
+
+			return !m_failed;
+		}
+
+		bool ChunkedMapWriter::writeBand(const std::uint8_t* tiles, int bandRows)
+		{
+			if (!m_file || m_failed || bandRows <= 0 || bandRows > ChunkedMap::chunkSize || m_written + bandRows > m_rows) return false;
+			// Only the last band may be short
+			if (bandRows < ChunkedMap::chunkSize && m_written + bandRows != m_rows) return false;
+
+			for (int chunkColumn{}; chunkColumn < chunkCount(m_columns); chunkColumn++) {
+				const int left = chunkColumn * ChunkedMap::chunkSize;
+				const int width = std::min(ChunkedMap::chunkSize, m_columns - left);
+
+				// Tiles past the edge of the map are obstacles
+				std::fill(m_chunk.begin(), m_chunk.end(), std::uint8_t{});
+				for (int row{}; row < bandRows; row++)
+					std::memcpy(&m_chunk[static_cast<std::size_t>(row) * ChunkedMap::chunkSize], tiles + static_cast<std::size_t>(row) * m_columns + left, width);
+
+				ChunkedMap::ChunkEntry entry{};
+
+				if (std::all_of(m_chunk.begin(), m_chunk.end(), [&](std::uint8_t tile) { return tile == m_chunk.front(); })) entry.fill = m_chunk.front();
+				else {
+					entry.offset = m_offset;
+					m_failed = m_failed || std::fwrite(m_chunk.data(), 1, m_chunk.size(), m_file) != m_chunk.size();
+					m_offset += m_chunk.size();
+				}
+
+				m_entries.push_back(entry);
+			}
+
+			m_written += bandRows;
+			return !m_failed;
+		}
+
+		bool ChunkedMapWriter::close()
+		{
+			if (!m_file) return false;
+
+			FileHeader header{};
+			std::memcpy(header.magic, magic, sizeof(magic));
+			header.version = version;
+			header.rows = m_rows;
+			header.columns = m_columns;
+			header.chunkShift = ChunkedMap::chunkShift;
+			header.indexOffset = m_offset;
+
+			bool written = !m_failed && m_written == m_rows
+				&& std::fwrite(m_entries.data(), sizeof(ChunkedMap::ChunkEntry), m_entries.size(), m_file) == m_entries.size()
+				&& std::fseek(m_file, 0, SEEK_SET) == 0
+				&& std::fwrite(&header, sizeof(header), 1, m_file) == 1;
+
+			written = std::fclose(m_file) == 0 && written;
+			m_file = nullptr;
+			m_entries.clear();
+
+			return written;
+		}
+
+		bool writeChunkedMap(const std::string& path, const Map& map)
+		{
+			ChunkedMapWriter writer{};
+			if (!writer.open(path, map.rows(), map.columns())) return false;
+
+			std::vector<std::uint8_t> band(static_cast<std::size_t>(ChunkedMap::chunkSize) * map.columns());
+
+			for (int top{}; top < map.rows(); top += ChunkedMap::chunkSize) {
+				int bandRows = std::min(ChunkedMap::chunkSize, map.rows() - top);
+
+				for (int row{}; row < bandRows; row++)
+					std::memcpy(&band[static_cast<std::size_t>(row) * map.columns()], map.cells() + map.id(top + row, 0), map.columns());
+
+				if (!writer.writeBand(band.data(), bandRows)) return false;
+			}
+
+			return writer.close();
+		}
+	}
+}
@@ -0,0 +1,46 @@
+#include "../../include/pathfinding/control.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		void SearchControl::reset()
+		{
+			std::lock_guard<std::mutex> lock{ m_mutex };
+
+			m_cancelled.store(false, std::memory_order_relaxed);
+			m_publishing.store(true, std::memory_order_relaxed);
+			m_pending.clear();
+			m_published = 0;
+		}
+
+		void SearchControl::setPublishing(bool publishing)
+		{
+			std::lock_guard<std::mutex> lock{ m_mutex };
+
+			m_publishing.store(publishing, std::memory_order_relaxed);
+			if (!publishing) {
+				m_pending.clear();
+				m_pending.shrink_to_fit();
+			}
+		}
+
+		void SearchControl::publish(const std::vector<TileId>& checked)
+		{
+			std::lock_guard<std::mutex> lock{ m_mutex };
+
+			// Turned off since the engine checked
+			if (!m_publishing.load(std::memory_order_relaxed)) return;
+
+			m_pending.insert(m_pending.end(), checked.begin() + m_published, checked.end());
+			m_published = checked.size();
+		}
+
+		void SearchControl::take(std::vector<TileId>& tiles)
+		{
+			std::lock_guard<std::mutex> lock{ m_mutex };
+
+			tiles.insert(tiles.end(), m_pending.begin(), m_pending.end());
+			m_pending.clear();
+		}
+	}
+}
@@ -0,0 +1,86 @@
+#include "../../include/pathfinding/dial.h"
+#include "../../include/pathfinding/path.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		void DialEngine::search(const Map& map, Position startTile, Position finishTile, SearchResult& result, SearchControl* control)
+		{
+			result.clear();
+
+			const TileId start = map.id(startTile);
+			const TileId finish = map.id(finishTile);
+			const auto offsets = map.neighbourOffsets();
+			const std::uint8_t* cells = map.cells();
+			const int stride = map.stride();
+			const int finishRow = static_cast<int>(finish / stride);
+			const int finishColumn = static_cast<int>(finish % stride);
+
+			auto heuristic = [=](TileId tile) {
+				return static_cast<std::uint32_t>(abs(static_cast<int>(tile / stride) - finishRow) + abs(static_cast<int>(tile % stride) - finishColumn));
+			};
+
+			m_state.prepare(map.size());
+			if (m_gCost.size() != map.size()) {
+				m_gCost.resize(map.size());
+				m_parent.resize(map.size());
+			}
+
+			m_open.clear();
+
+			std::uint32_t startH = heuristic(start);
+			m_state.open(start);
+			m_gCost[start] = 0;
+			m_parent[start] = start;
+			m_open.push({ startH, startH, start });
+			result.stats.pushed = 1;
+
+			while (!m_open.empty()) {
+				OpenNode current = m_open.pop();
+
+				// A cheaper copy of this tile was already expanded
+				if (m_state.isClosed(current.tile)) {
+					result.stats.stalePops++;
+					continue;
+				}
+				m_state.close(current.tile);
+
+				if (current.tile == finish) {
+					reconstructPath(m_parent, start, finish, result.path);
+					result.cost = static_cast<double>(m_gCost[finish]);
+					result.found = true;
+					return;
+				}
+
+				if (current.tile != start) result.checked.push_back(current.tile);
+				if (!keepSearching(control, result.checked)) return;
+
+				result.stats.expanded++;
+
+				for (auto offset : offsets)
+				{
+					TileId next = static_cast<TileId>(current.tile + offset);
+
+					if (!cells[next]) continue;
+
+					const std::uint64_t gCost = m_gCost[current.tile] + cells[next];
+
+					if (m_state.isSeen(next)) {
+						if (m_state.isClosed(next) || gCost >= m_gCost[next]) continue;
+					}
+					else m_state.open(next);
+
+					m_gCost[next] = gCost;
+					m_parent[next] = current.tile;
+
+					// The buckets only need f modulo 2^32
+					std::uint32_t hCost = heuristic(next);
+					m_open.push({ static_cast<std::uint32_t>(gCost + hCost), hCost, next });
+					result.stats.pushed++;
+				}
+
+				result.stats.peakOpen = std::max<std::uint64_t>(result.stats.peakOpen, m_open.size());
+			}
+		}
+	}
+}
@@ -0,0 +1,235 @@
+#include "../../include/pathfinding/dstar_lite.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		std::uint32_t DStarLiteEngine::heuristic(TileId a, TileId b) const
+		{
+			return abs(static_cast<int>(a / m_stride) - static_cast<int>(b / m_stride)) + abs(static_cast<int>(a % m_stride) - static_cast<int>(b % m_stride));
+		}
+
+		DStarLiteEngine::Key DStarLiteEngine::calculateKey(TileId tile) const
+		{
+			std::uint32_t best = std::min(m_g[tile], m_rhs[tile]);
+
+			return { best + heuristic(m_start, tile) + m_keyModifier, best };
+		}
+
+		// Cheapest way to the finish through one of the neighbours
+		std::uint32_t DStarLiteEngine::lookahead(TileId tile) const
+		{
+			std::uint32_t best{ infinity };
+
+			for (auto offset : m_offsets) {
+				TileId next = static_cast<TileId>(tile + offset);
+				std::uint32_t step = cost(tile, next);
+
+				if (step != infinity && m_g[next] != infinity) best = std::min(best, step + m_g[next]);
+			}
+
+			return best;
+		}
+
+		void DStarLiteEngine::push(TileId tile, Key key)
+		{
+			m_queuedKey[tile] = key;
+			m_inQueue[tile] = true;
+			m_queue.push_back({ key, tile });
+			std::push_heap(m_queue.begin(), m_queue.end(), [](const QueueEntry& a, const QueueEntry& b) { return b.key < a.key; });
+
+			m_stats.pushed++;
+			m_stats.peakOpen = std::max<std::uint64_t>(m_stats.peakOpen, m_queue.size());
+		}
+
+		bool DStarLiteEngine::top(QueueEntry& entry)
+		{
+			while (!m_queue.empty()) {
+				entry = m_queue.front();
+
+				if (m_inQueue[entry.tile] && m_queuedKey[entry.tile] == entry.key) return true;
+
+				pop();
+				m_stats.stalePops++;
+			}
+
+			return false;
+		}
+
+		void DStarLiteEngine::pop()
+		{
+			std::pop_heap(m_queue.begin(), m_queue.end(), [](const QueueEntry& a, const QueueEntry& b) { return b.key < a.key; });
+			m_queue.pop_back();
+		}
+
+		void DStarLiteEngine::updateVertex(TileId tile)
+		{
+			if (m_g[tile] != m_rhs[tile]) push(tile, calculateKey(tile));
+			else m_inQueue[tile] = false;
+		}
+
+		void DStarLiteEngine::initialize(const Map& map, TileId start, TileId finish)
+		{
+			m_size = map.size();
+			m_finish = finish;
+			m_lastStart = start;
+			m_keyModifier = 0;
+
+			m_g.assign(m_size, infinity);
+			m_rhs.assign(m_size, infinity);
+			m_queuedKey.assign(m_size, {});
+			m_inQueue.assign(m_size, false);
+			m_queue.clear();
+
+			m_rhs[m_finish] = 0;
+			push(m_finish, calculateKey(m_finish));
+		}
+
+		void DStarLiteEngine::sync(const Map& map, TileId start, TileId finish)
+		{
+			m_cells = map.cells();
+			m_offsets = map.neighbourOffsets();
+			m_stride = map.stride();
+			m_start = start;
+
+			if (m_size != map.size() || m_finish != finish || !map.changesSince(m_revision, m_changed)) {
+				initialize(map, start, finish);
+				m_revision = map.revision();
+				return;
+			}
+
+			// Keys already queued stay valid lower bounds when the start moves
+			if (m_start != m_lastStart) {
+				m_keyModifier += heuristic(m_lastStart, m_start);
+
+				// The start may be left even when it's on an obstacle, so both tiles change their edges
+				for (TileId tile : { m_lastStart, m_start }) {
+					if (tile == m_finish) continue;
+
+					m_rhs[tile] = lookahead(tile);
+					updateVertex(tile);
+				}
+
+				m_lastStart = m_start;
+			}
+
+			// An edited tile changes the cost of its own edges and its neighbours' edges
+			for (TileId tile : m_changed) {
+				for (int i{ -1 }; i < 4; i++) {
+					TileId affected = i < 0 ? tile : static_cast<TileId>(tile + m_offsets[i]);
+
+					if (affected == m_finish) continue;
+
+					m_rhs[affected] = lookahead(affected);
+					updateVertex(affected);
+				}
+			}
+
+			m_revision = map.revision();
+		}
+
+		bool DStarLiteEngine::computeShortestPath(SearchResult& result, SearchControl* control)
+		{
+			QueueEntry entry{};
+
+			while (top(entry) && (entry.key < calculateKey(m_start) || m_rhs[m_start] > m_g[m_start])) {
+				if (!keepSearching(control, result.checked)) return false;
+
+				const TileId tile = entry.tile;
+				const Key newKey = calculateKey(tile);
+
+				if (entry.key < newKey) {
+					push(tile, newKey);
+					continue;
+				}
+
+				// Take it off now, so only outdated entries are left for top to drop
+				pop();
+				m_inQueue[tile] = false;
+				if (tile != m_start && tile != m_finish) result.checked.push_back(tile);
+				m_stats.expanded++;
+
+				// Locally overconsistent, settle it and offer it to the neighbours
+				if (m_g[tile] > m_rhs[tile]) {
+					m_g[tile] = m_rhs[tile];
+
+					for (auto offset : m_offsets) {
+						TileId next = static_cast<TileId>(tile + offset);
+						std::uint32_t step = cost(next, tile);
+
+						if (next == m_finish || step == infinity) continue;
+
+						if (step + m_g[tile] < m_rhs[next]) {
+							m_rhs[next] = step + m_g[tile];
+							updateVertex(next);
+						}
+					}
+				}
+
+				// Underconsistent, forget its distance and let everything that relied on it look again
+				else {
+					const std::uint32_t oldG = m_g[tile];
+					m_g[tile] = infinity;
+
+					for (int i{ -1 }; i < 4; i++) {
+						TileId next = i < 0 ? tile : static_cast<TileId>(tile + m_offsets[i]);
+
+						if (next == m_finish) continue;
+
+						if (next == tile || m_rhs[next] == cost(next, tile) + oldG) m_rhs[next] = lookahead(next);
+						updateVertex(next);
+					}
+				}
+			}
+
+			return true;
+		}
+
+		void DStarLiteEngine::search(const Map& map, Position startTile, Position finishTile, SearchResult& result, SearchControl* control)
+		{
+			result.clear();
+
+			// Repairs queued while syncing count towards this query
+			m_stats = {};
+
+			auto preprocess = std::chrono::steady_clock::now();
+			sync(map, map.id(startTile), map.id(finishTile));
+			m_stats.preprocessSeconds = secondsSince(preprocess);
+
+			bool finished = computeShortestPath(result, control);
+			result.stats = m_stats;
+
+			if (!finished) return;
+
+			if (m_g[m_start] == infinity && m_rhs[m_start] == infinity) return;
+
+			// Follow the cheapest neighbour down to the finish
+			TileId current = m_start;
+
+			while (current != m_finish) {
+				TileId best{ invalidTile };
+				std::uint32_t bestCost{ infinity };
+
+				for (auto offset : m_offsets) {
+					TileId next = static_cast<TileId>(current + offset);
+					std::uint32_t step = cost(current, next);
+
+					if (step != infinity && m_g[next] != infinity && step + m_g[next] < bestCost) {
+						bestCost = step + m_g[next];
+						best = next;
+					}
+				}
+
+				if (best == invalidTile || result.path.size() > map.size()) {
+					result.path.clear();
+					return;
+				}
+
+				if (best != m_finish) result.path.push_back(best);
+				current = best;
+			}
+
+			result.cost = m_rhs[m_start];
+			result.found = true;
+		}
+	}
+}
@@ -0,0 +1,291 @@
+#include "../../include/pathfinding/flood_fill.h"
+#include "../../include/pathfinding/bitgrid.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace engine {
+	namespace pathfinding {
+
+		void FloodFillEngine::sync(const Map& map)
+		{
+			bool sameShape = m_size == map.size() && m_stride == map.stride();
+
+			if (sameShape && m_revision == map.revision()) return;
+
+			if (sameShape && map.changesSince(m_revision, m_changed)) {
+				for (TileId tile : m_changed) {
+					std::uint64_t bit = std::uint64_t{ 1 } << (tile & 63);
+
+					if (map.isWalkable(tile)) m_walkable[wordIndex(tile)] |= bit;
+					else m_walkable[wordIndex(tile)] &= ~bit;
+				}
+			}
+			else {
+				m_size = map.size();
+				m_stride = map.stride();
+				m_mapWords = (m_size + 63) / 64;
+				// Shifting by a stride reads one word past the stride's whole words
+				m_margin = static_cast<std::size_t>(m_stride) / 64 + 2;
+
+				std::size_t words = m_mapWords + 2 * m_margin;
+				m_walkable.assign(words, 0);
+				m_visited.assign(words, 0);
+				m_frontier.assign(words, 0);
+				m_next.assign(words, 0);
+				m_marks.assign(words / 64 + 1, 0);
+				m_markedWords.assign(m_marks.size() / 64 + 1, 0);
+				m_distance.resize(m_size);
+				m_ringWords.clear();
+				m_ringBits.clear();
+				m_ringStarts.clear();
+
+				const std::uint8_t* cells = map.cells();
+				for (TileId tile{}; tile < m_size; tile++) {
+					if (cells[tile]) m_walkable[wordIndex(tile)] |= std::uint64_t{ 1 } << (tile & 63);
+				}
+			}
+
+			m_revision = map.revision();
+		}
+
+		std::uint64_t FloodFillEngine::reach(std::size_t word) const
+		{
+			const std::uint64_t* frontier = m_frontier.data();
+			const std::size_t words = static_cast<std::size_t>(m_stride) / 64;
+			const unsigned bits = static_cast<unsigned>(m_stride) % 64;
+
+			std::uint64_t fromLeft = (frontier[word] << 1) | (frontier[word - 1] >> 63);
+			std::uint64_t fromRight = (frontier[word] >> 1) | (frontier[word + 1] << 63);
+			std::uint64_t fromAbove = frontier[word - words] << bits;
+			std::uint64_t fromBelow = frontier[word + words] >> bits;
+
+			if (bits) {
+				fromAbove |= frontier[word - words - 1] >> (64 - bits);
+				fromBelow |= frontier[word + words + 1] << (64 - bits);
+			}
+
+			return (fromLeft | fromRight | fromAbove | fromBelow) & m_walkable[word] & ~m_visited[word];
+		}
+
+		void FloodFillEngine::grow(Span span)
+		{
+			std::uint64_t* next = m_next.data();
+			std::size_t word = span.begin;
+
+#ifdef __AVX2__
+			const std::uint64_t* frontier = m_frontier.data();
+			const std::uint64_t* walkable = m_walkable.data();
+			const std::uint64_t* visited = m_visited.data();
+			const std::size_t words = static_cast<std::size_t>(m_stride) / 64;
+			const unsigned bits = static_cast<unsigned>(m_stride) % 64;
+
+			// Shift counts of 64 give zero, so a stride that's a whole number of words needs no special case
+			const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(bits));
+			const __m128i carry = _mm_cvtsi32_si128(static_cast<int>(64 - bits));
+
+			auto load = [](const std::uint64_t* source) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source)); };
+
+			for (; word + 4 <= span.end; word += 4) {
+				__m256i fromLeft = _mm256_or_si256(_mm256_slli_epi64(load(frontier + word), 1), _mm256_srli_epi64(load(frontier + word - 1), 63));
+				__m256i fromRight = _mm256_or_si256(_mm256_srli_epi64(load(frontier + word), 1), _mm256_slli_epi64(load(frontier + word + 1), 63));
+				__m256i fromAbove = _mm256_or_si256(_mm256_sll_epi64(load(frontier + word - words), shift), _mm256_srl_epi64(load(frontier + word - words - 1), carry));
+				__m256i fromBelow = _mm256_or_si256(_mm256_srl_epi64(load(frontier + word + words), shift), _mm256_sll_epi64(load(frontier + word + words + 1), carry));
+
+				__m256i reached = _mm256_or_si256(_mm256_or_si256(fromLeft, fromRight), _mm256_or_si256(fromAbove, fromBelow));
+				reached = _mm256_andnot_si256(load(visited + word), _mm256_and_si256(reached, load(walkable + word)));
+
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(next + word), reached);
+			}
+#endif
+
+			for (; word < span.end; word++) next[word] = reach(word);
+		}
+
+		void FloodFillEngine::collect(std::size_t word, std::uint64_t reached, std::uint32_t ring, TileId target, std::vector<TileId>* checked, bool distances, bool& found)
+		{
+			m_next[word] = reached;
+			m_visited[word] |= reached;
+			m_ringWords.push_back(word);
+			m_ringBits.push_back(reached);
+
+			if (target < m_size && word == wordIndex(target) && (reached >> (target & 63)) & 1) found = true;
+			if (!checked && !distances) return;
+
+			for (; reached; reached &= reached - 1) {
+				TileId tile = static_cast<TileId>((word - m_margin) * 64 + countTrailingZeros(reached));
+
+				if (distances) m_distance[tile] = ring;
+				if (checked) checked->push_back(tile);
+			}
+		}
+
+		bool FloodFillEngine::inRing(std::uint32_t ring, TileId tile) const
+		{
+			if (tile >= m_size) return false;
+
+			auto begin = m_ringWords.begin() + m_ringStarts[ring];
+			auto end = m_ringWords.begin() + m_ringStarts[ring + 1];
+			auto word = std::lower_bound(begin, end, wordIndex(tile));
+
+			return word != end && *word == wordIndex(tile) && (m_ringBits[word - m_ringWords.begin()] >> (tile & 63)) & 1;
+		}
+
+		bool FloodFillEngine::flood(TileId source, TileId target, std::vector<TileId>* checked, bool distances, SearchStats* stats, SearchControl* control)
+		{
+			// Only the words the last flood reached can be set, its final frontier among them
+			for (std::size_t word : m_ringWords) {
+				m_visited[word] = 0;
+				m_frontier[word] = 0;
+			}
+
+			const std::size_t words = static_cast<std::size_t>(m_stride) / 64;
+			const unsigned strideBits = static_cast<unsigned>(m_stride) % 64;
+			const std::size_t first = m_margin;
+			const std::size_t last = m_margin + m_mapWords;
+			const std::uint64_t sourceBit = std::uint64_t{ 1 } << (source & 63);
+
+			m_visited[wordIndex(source)] |= sourceBit;
+			m_frontier[wordIndex(source)] |= sourceBit;
+			if (distances) m_distance[source] = 0;
+
+			m_ringWords.assign(1, wordIndex(source));
+			m_ringBits.assign(1, sourceBit);
+			m_ringStarts.assign({ 0, 1 });
+
+			bool found = source == target;
+
+			// Stats are only counted along with the checked tiles, the ring sizes come from them
+			std::size_t ringSize{ 1 };
+			if (stats) stats->pushed = 1;
+
+			for (std::uint32_t ring{ 1 }; m_ringStarts[ring - 1] < m_ringStarts[ring] && !found; ring++) {
+				if (checked && !keepSearching(control, *checked)) break;
+
+				if (stats) {
+					stats->expanded += ringSize;
+					stats->peakOpen = std::max<std::uint64_t>(stats->peakOpen, ringSize);
+				}
+
+				const std::size_t activeBegin = m_ringStarts[ring - 1];
+				const std::size_t activeEnd = m_ringStarts[ring];
+
+				// Mark the words a frontier word's tiles step into: itself, a neighbour for its end
+				// bits, and the one or two words a stride up and down its bits land in
+				auto markWord = [this](std::size_t word) {
+					m_marks[word >> 6] |= std::uint64_t{ 1 } << (word & 63);
+					m_markedWords[word >> 12] |= std::uint64_t{ 1 } << ((word >> 6) & 63);
+				};
+
+				for (std::size_t active = activeBegin; active < activeEnd; active++) {
+					const std::size_t word = m_ringWords[active];
+					const std::uint64_t tiles = m_ringBits[active];
+
+					markWord(word);
+					if (tiles & 1) markWord(word - 1);
+					if (tiles >> 63) markWord(word + 1);
+					if (tiles >> strideBits) markWord(word - words);
+					if (tiles << strideBits) markWord(word + words);
+
+					if (strideBits) {
+						if (tiles << (64 - strideBits)) markWord(word - words - 1);
+						if (tiles >> (64 - strideBits)) markWord(word + words + 1);
+					}
+				}
+
+				std::size_t ringStart = checked ? checked->size() : 0;
+
+				// Marks come out in word order, which keeps each ring's words sorted
+				for (std::size_t summary{}; summary < m_markedWords.size(); summary++) {
+					for (std::uint64_t marked = m_markedWords[summary]; marked; marked &= marked - 1) {
+						const std::size_t mark = summary * 64 + countTrailingZeros(marked);
+						std::uint64_t bits = m_marks[mark];
+						m_marks[mark] = 0;
+
+						while (bits) {
+							const int bit = countTrailingZeros(bits);
+							std::size_t word = mark * 64 + bit;
+
+							if (word < first || word >= last) {
+								bits &= bits - 1;
+								continue;
+							}
+
+#ifdef __AVX2__
+							// Four marked words in a row are grown in one register
+							if (((bits >> bit) & 15) == 15 && word + 4 <= last) {
+								grow({ word, word + 4 });
+								bits &= ~(std::uint64_t{ 15 } << bit);
+
+								for (std::size_t end = word + 4; word < end; word++)
+									if (m_next[word]) collect(word, m_next[word], ring, target, checked, distances, found);
+								continue;
+							}
+#endif
+
+							bits &= bits - 1;
+							if (std::uint64_t reached = reach(word)) collect(word, reached, ring, target, checked, distances, found);
+						}
+					}
+
+					m_markedWords[summary] = 0;
+				}
+
+				m_ringStarts.push_back(m_ringWords.size());
+
+				if (checked) ringSize = checked->size() - ringStart;
+				if (stats) stats->pushed += ringSize;
+
+				// Tiles of the ring that reaches the target were never expanded
+				if (found && checked) checked->resize(ringStart);
+
+				for (std::size_t active = activeBegin; active < activeEnd; active++) m_frontier[m_ringWords[active]] = 0;
+				std::swap(m_frontier, m_next);
+			}
+
+			return found;
+		}
+
+		void FloodFillEngine::fill(const Map& map, TileId source)
+		{
+			sync(map);
+			flood(source, invalidTile, nullptr, true, nullptr, nullptr);
+		}
+
+		void FloodFillEngine::search(const Map& map, Position startTile, Position finishTile, SearchResult& result, SearchControl* control)
+		{
+			result.clear();
+
+			auto preprocess = std::chrono::steady_clock::now();
+			sync(map);
+			result.stats.preprocessSeconds = secondsSince(preprocess);
+
+			const TileId start = map.id(startTile);
+			const TileId finish = map.id(finishTile);
+
+			if (!flood(start, finish, &result.checked, false, &result.stats, control)) return;
+
+			// The ring that reached the finish is its distance, step back through the rings before it
+			const std::uint32_t distance = static_cast<std::uint32_t>(m_ringStarts.size() - 2);
+			TileId tile = finish;
+
+			for (std::uint32_t ring = distance; ring > 1; ring--) {
+				for (auto offset : map.neighbourOffsets()) {
+					TileId previous = static_cast<TileId>(tile + offset);
+
+					if (inRing(ring - 1, previous)) {
+						tile = previous;
+						break;
+					}
+				}
+
+				result.path.push_back(tile);
+			}
+
+			std::reverse(result.path.begin(), result.path.end());
+			result.cost = distance;
+			result.found = true;
+		}
+	}
+}
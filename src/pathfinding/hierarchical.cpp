@@ -0,0 +1,350 @@
+#include "../../include/pathfinding/hierarchical.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		namespace {
+
+			constexpr std::uint32_t unreachable{ ~std::uint32_t{} };
+
+			// Open stretches at least this long get an entrance at both ends instead of one in the middle
+			constexpr int longEntrance{ 6 };
+
+			constexpr std::array<int, 4> rowSteps{ 0, 0, -1, 1 };
+			constexpr std::array<int, 4> columnSteps{ -1, 1, 0, 0 };
+		}
+
+		std::size_t HierarchicalEngine::memoryUsage() const
+		{
+			std::size_t bytes = capacityBytes(m_clusters) + capacityBytes(m_dirty) + m_isDirty.capacity() / 8 + capacityBytes(m_changed);
+
+			for (const Cluster& cluster : m_clusters)
+				bytes += capacityBytes(cluster.entrances) + capacityBytes(cluster.partners) + capacityBytes(cluster.distances);
+
+			return bytes + m_state.memoryUsage() + capacityBytes(m_gCost) + capacityBytes(m_parent) + m_open.memoryUsage() + capacityBytes(m_abstractPath)
+				+ capacityBytes(m_localDistance) + capacityBytes(m_localParent) + capacityBytes(m_localQueue) + capacityBytes(m_startDistance) + capacityBytes(m_finishDistance);
+		}
+
+		Position HierarchicalEngine::clusterOrigin(std::size_t cluster) const
+		{
+			return { static_cast<int>(cluster / m_clusterColumns) * clusterSize, static_cast<int>(cluster % m_clusterColumns) * clusterSize };
+		}
+
+		std::size_t HierarchicalEngine::localIndex(const Map& map, std::size_t cluster, TileId tile) const
+		{
+			Position origin = clusterOrigin(cluster);
+			Position position = map.position(tile);
+
+			return static_cast<std::size_t>(position.row - origin.row) * clusterSize + position.column - origin.column;
+		}
+
+		void HierarchicalEngine::localSearch(const Map& map, std::size_t cluster, TileId source)
+		{
+			const Position origin = clusterOrigin(cluster);
+			const int rows = std::min(clusterSize, m_rows - origin.row);
+			const int columns = std::min(clusterSize, m_columns - origin.column);
+			const std::uint8_t* cells = map.cells();
+
+			std::fill(m_localDistance.begin(), m_localDistance.end(), unreachable);
+			m_localQueue.clear();
+
+			auto sourceIndex = static_cast<std::uint16_t>(localIndex(map, cluster, source));
+			m_localDistance[sourceIndex] = 0;
+			m_localParent[sourceIndex] = sourceIndex;
+			m_localQueue.push_back(sourceIndex);
+
+			for (std::size_t head{}; head < m_localQueue.size(); head++) {
+				std::uint16_t current = m_localQueue[head];
+				int row = current / clusterSize;
+				int column = current % clusterSize;
+
+				for (int i{}; i < 4; i++) {
+					int nextRow = row + rowSteps[i];
+					int nextColumn = column + columnSteps[i];
+
+					if (nextRow < 0 || nextRow >= rows || nextColumn < 0 || nextColumn >= columns) continue;
+
+					auto next = static_cast<std::uint16_t>(nextRow * clusterSize + nextColumn);
+
+					if (m_localDistance[next] != unreachable || !cells[map.id(origin.row + nextRow, origin.column + nextColumn)]) continue;
+
+					m_localDistance[next] = m_localDistance[current] + 1;
+					m_localParent[next] = current;
+					m_localQueue.push_back(next);
+				}
+			}
+		}
+
+		void HierarchicalEngine::addBorder(const Map& map, Cluster& cluster, Position first, Position step, Position across, int length)
+		{
+			auto isOpen = [&](int i) {
+				Position inside{ first.row + step.row * i, first.column + step.column * i };
+				Position outside{ inside.row + across.row, inside.column + across.column };
+
+				return map.isWalkable(map.id(inside)) && map.isWalkable(map.id(outside));
+			};
+
+			auto add = [&](int i) {
+				Position inside{ first.row + step.row * i, first.column + step.column * i };
+
+				cluster.entrances.push_back(map.id(inside));
+				cluster.partners.push_back(map.id(inside.row + across.row, inside.column + across.column));
+			};
+
+			// Both clusters on a border find the same stretches, so their entrances always pair up
+			for (int i{}; i < length;) {
+				if (!isOpen(i)) {
+					i++;
+					continue;
+				}
+
+				int end = i;
+				while (end + 1 < length && isOpen(end + 1)) end++;
+
+				if (end - i + 1 >= longEntrance) {
+					add(i);
+					add(end);
+				}
+				else add((i + end) / 2);
+
+				i = end + 1;
+			}
+		}
+
+		void HierarchicalEngine::rebuild(const Map& map, std::size_t index)
+		{
+			Cluster& cluster = m_clusters[index];
+			const Position origin = clusterOrigin(index);
+			const int rows = std::min(clusterSize, m_rows - origin.row);
+			const int columns = std::min(clusterSize, m_columns - origin.column);
+
+			cluster.entrances.clear();
+			cluster.partners.clear();
+
+			if (origin.row > 0) addBorder(map, cluster, origin, { 0, 1 }, { -1, 0 }, columns);
+			if (origin.row + rows < m_rows) addBorder(map, cluster, { origin.row + rows - 1, origin.column }, { 0, 1 }, { 1, 0 }, columns);
+			if (origin.column > 0) addBorder(map, cluster, origin, { 1, 0 }, { 0, -1 }, rows);
+			if (origin.column + columns < m_columns) addBorder(map, cluster, { origin.row, origin.column + columns - 1 }, { 1, 0 }, { 0, 1 }, rows);
+
+			const std::size_t count = cluster.entrances.size();
+			cluster.distances.assign(count * count, unreachable);
+
+			for (std::size_t i{}; i < count; i++) {
+				localSearch(map, index, cluster.entrances[i]);
+
+				for (std::size_t j{}; j < count; j++)
+					cluster.distances[i * count + j] = m_localDistance[localIndex(map, index, cluster.entrances[j])];
+			}
+		}
+
+		void HierarchicalEngine::markDirty(std::size_t cluster)
+		{
+			if (m_isDirty[cluster]) return;
+
+			m_isDirty[cluster] = true;
+			m_dirty.push_back(cluster);
+		}
+
+		bool HierarchicalEngine::sync(const Map& map, SearchControl* control)
+		{
+			if (m_revision == map.revision()) return true;
+
+			bool sameSize = m_rows == map.rows() && m_columns == map.columns();
+
+			if (sameSize && map.changesSince(m_revision, m_changed)) {
+				for (TileId tile : m_changed) {
+					Position position = map.position(tile);
+					std::size_t cluster = clusterOf(position);
+					int row = position.row % clusterSize;
+					int column = position.column % clusterSize;
+
+					markDirty(cluster);
+
+					// Edits on a border change the entrances of the cluster across it too
+					if (row == 0 && position.row > 0) markDirty(cluster - m_clusterColumns);
+					if (row == clusterSize - 1 && position.row + 1 < m_rows) markDirty(cluster + m_clusterColumns);
+					if (column == 0 && position.column > 0) markDirty(cluster - 1);
+					if (column == clusterSize - 1 && position.column + 1 < m_columns) markDirty(cluster + 1);
+				}
+			}
+			else {
+				m_rows = map.rows();
+				m_columns = map.columns();
+				m_clusterRows = (m_rows + clusterSize - 1) / clusterSize;
+				m_clusterColumns = (m_columns + clusterSize - 1) / clusterSize;
+
+				std::size_t clusterCount = static_cast<std::size_t>(m_clusterRows) * m_clusterColumns;
+				m_clusters.assign(clusterCount, {});
+				m_isDirty.assign(clusterCount, false);
+				m_dirty.clear();
+
+				m_localDistance.resize(clusterSize * clusterSize);
+				m_localParent.resize(clusterSize * clusterSize);
+
+				for (std::size_t cluster{}; cluster < clusterCount; cluster++) markDirty(cluster);
+			}
+
+			// The map revision only moves once every dirty cluster is rebuilt
+			while (!m_dirty.empty()) {
+				if (control && control->cancelled()) return false;
+
+				std::size_t cluster = m_dirty.back();
+				rebuild(map, cluster);
+				m_isDirty[cluster] = false;
+				m_dirty.pop_back();
+			}
+
+			m_revision = map.revision();
+			return true;
+		}
+
+		void HierarchicalEngine::relax(const Map& map, TileId from, TileId to, std::uint32_t distance)
+		{
+			if (distance == unreachable) return;
+
+			std::uint32_t gCost = m_gCost[from] + distance;
+
+			if (m_state.isSeen(to)) {
+				if (m_state.isClosed(to) || gCost >= m_gCost[to]) return;
+			}
+			else m_state.open(to);
+
+			m_gCost[to] = gCost;
+			m_parent[to] = from;
+
+			Position position = map.position(to);
+			std::uint32_t hCost = abs(position.row - m_finishTile.row) + abs(position.column - m_finishTile.column);
+			m_open.push({ gCost + hCost, hCost, to });
+			m_pushed++;
+		}
+
+		void HierarchicalEngine::expand(const Map& map, TileId tile, TileId start, TileId finish, std::size_t finishCluster)
+		{
+			const std::size_t index = clusterOf(map.position(tile));
+			const Cluster& cluster = m_clusters[index];
+			const std::size_t count = cluster.entrances.size();
+
+			if (tile == start) {
+				for (std::size_t j{}; j < count; j++)
+					relax(map, tile, cluster.entrances[j], m_startDistance[localIndex(map, index, cluster.entrances[j])]);
+			}
+
+			auto entrance = std::find(cluster.entrances.begin(), cluster.entrances.end(), tile);
+
+			if (entrance != cluster.entrances.end()) {
+				std::size_t i = entrance - cluster.entrances.begin();
+
+				for (std::size_t j{}; j < count; j++) {
+					if (cluster.entrances[j] == tile) relax(map, tile, cluster.partners[j], 1);
+					else relax(map, tile, cluster.entrances[j], cluster.distances[i * count + j]);
+				}
+			}
+
+			// The finish search can't step onto a blocked start, the start's own search can leave it
+			if (index == finishCluster) relax(map, tile, finish, tile == start ? m_startDistance[localIndex(map, index, finish)] : m_finishDistance[localIndex(map, index, tile)]);
+		}
+
+		void HierarchicalEngine::refine(const Map& map, TileId start, TileId finish, std::vector<TileId>& path)
+		{
+			m_abstractPath.clear();
+			for (TileId tile = finish; tile != start; tile = m_parent[tile]) m_abstractPath.push_back(tile);
+			m_abstractPath.push_back(start);
+			std::reverse(m_abstractPath.begin(), m_abstractPath.end());
+
+			path.clear();
+
+			for (std::size_t i{ 1 }; i < m_abstractPath.size(); i++) {
+				TileId from = m_abstractPath[i - 1];
+				TileId to = m_abstractPath[i];
+				std::size_t first = path.size();
+
+				// Every other abstract edge stays inside the cluster of its first tile
+				if (m_gCost[to] - m_gCost[from] > 1) {
+					std::size_t cluster = clusterOf(map.position(from));
+					Position origin = clusterOrigin(cluster);
+
+					localSearch(map, cluster, from);
+
+					auto source = static_cast<std::uint16_t>(localIndex(map, cluster, from));
+					for (auto local = m_localParent[localIndex(map, cluster, to)]; local != source; local = m_localParent[local])
+						path.push_back(map.id(origin.row + local / clusterSize, origin.column + local % clusterSize));
+
+					std::reverse(path.begin() + first, path.end());
+				}
+
+				if (to != finish) path.push_back(to);
+			}
+		}
+
+		void HierarchicalEngine::search(const Map& map, Position startTile, Position finishTile, SearchResult& result, SearchControl* control)
+		{
+			result.clear();
+
+			auto preprocess = std::chrono::steady_clock::now();
+			bool synced = sync(map, control);
+			result.stats.preprocessSeconds = secondsSince(preprocess);
+
+			if (!synced) return;
+
+			const TileId start = map.id(startTile);
+			const TileId finish = map.id(finishTile);
+			const std::size_t finishCluster = clusterOf(finishTile);
+			m_finishTile = finishTile;
+
+			if (start == finish) {
+				result.found = true;
+				return;
+			}
+
+			// Like the other engines, a blocked finish can't be reached
+			if (!map.isWalkable(finish)) return;
+
+			// Link the start and finish to the entrances of their clusters
+			localSearch(map, clusterOf(startTile), start);
+			m_startDistance = m_localDistance;
+			localSearch(map, finishCluster, finish);
+			m_finishDistance = m_localDistance;
+
+			m_state.prepare(map.size());
+			if (m_gCost.size() != map.size()) {
+				m_gCost.resize(map.size());
+				m_parent.resize(map.size());
+			}
+
+			m_open.clear();
+			m_state.open(start);
+			m_gCost[start] = 0;
+			m_parent[start] = start;
+			m_open.push({ 0, 0, start });
+			m_pushed = 1;
+
+			while (!m_open.empty()) {
+				// Abstract edges push from inside relax, so the count is collected once per expansion
+				result.stats.pushed = m_pushed;
+				result.stats.peakOpen = std::max<std::uint64_t>(result.stats.peakOpen, m_open.size());
+
+				OpenNode current = m_open.pop();
+
+				// A better copy of this tile was already expanded
+				if (m_state.isClosed(current.tile)) {
+					result.stats.stalePops++;
+					continue;
+				}
+				m_state.close(current.tile);
+
+				if (current.tile == finish) {
+					refine(map, start, finish, result.path);
+					result.cost = m_gCost[finish];
+					result.found = true;
+					return;
+				}
+
+				if (current.tile != start) result.checked.push_back(current.tile);
+				if (!keepSearching(control, result.checked)) return;
+
+				result.stats.expanded++;
+				expand(map, current.tile, start, finish, finishCluster);
+			}
+		}
+	}
+}
@@ -0,0 +1,238 @@
+#include "../../include/pathfinding/history.h"
+
+#include <cstring>
+
+namespace engine {
+	namespace pathfinding {
+
+		namespace {
+
+			constexpr int chunkSize{ MapSnapshot::chunkSize };
+			constexpr int chunkShift{ MapSnapshot::chunkShift };
+
+			int chunkCount(int tiles) { return (tiles + chunkSize - 1) >> chunkShift; }
+
+			// Copy a chunk's tiles out of the map, 0 past its edge
+			void readChunk(const Map& map, int chunkColumns, std::uint32_t index, MapSnapshot::Chunk& chunk)
+			{
+				const int top = static_cast<int>(index / chunkColumns) << chunkShift;
+				const int left = static_cast<int>(index % chunkColumns) << chunkShift;
+				const int height = std::min(chunkSize, map.rows() - top);
+				const int width = std::min(chunkSize, map.columns() - left);
+
+				if (height < chunkSize || width < chunkSize) chunk.fill(0);
+
+				for (int row{}; row < height; row++)
+					std::memcpy(&chunk[static_cast<std::size_t>(row) * chunkSize], map.cells() + map.id(top + row, left), width);
+			}
+		}
+
+		void MapSnapshot::restore(Map& map, const std::vector<std::uint32_t>& chunks) const
+		{
+			assert(map.rows() == m_rows && map.columns() == m_columns);
+
+			for (std::uint32_t index : chunks) {
+				const Chunk& chunk = *m_chunks[index];
+				const int top = static_cast<int>(index / m_chunkColumns) << chunkShift;
+				const int left = static_cast<int>(index % m_chunkColumns) << chunkShift;
+				const int height = std::min(chunkSize, m_rows - top);
+				const int width = std::min(chunkSize, m_columns - left);
+
+				// Only the tiles that differ, so the map's change history stays precise for the engines
+				for (int row{}; row < height; row++) {
+					for (int column{}; column < width; column++) {
+						std::uint8_t cost = chunk[row * chunkSize + column];
+						if (map.cost(map.id(top + row, left + column)) != cost) map.setCost({ top + row, left + column }, cost);
+					}
+				}
+			}
+
+			map.setStart(m_start);
+			map.setFinish(m_finish);
+		}
+
+		void MapSnapshot::restore(Map& map, const MapSnapshot& base) const
+		{
+			assert(base.m_chunks.size() == m_chunks.size());
+
+			std::vector<std::uint32_t> changed{};
+
+			for (std::size_t index{}; index < m_chunks.size(); index++)
+				if (m_chunks[index] != base.m_chunks[index]) changed.push_back(static_cast<std::uint32_t>(index));
+
+			restore(map, changed);
+		}
+
+		void MapHistory::reset(const Map& map)
+		{
+			auto snapshot = std::make_shared<MapSnapshot>();
+			snapshot->m_rows = map.rows();
+			snapshot->m_columns = map.columns();
+			snapshot->m_chunkColumns = chunkCount(map.columns());
+			snapshot->m_start = map.start();
+			snapshot->m_finish = map.finish();
+
+			const std::size_t chunks = static_cast<std::size_t>(chunkCount(map.rows())) * snapshot->m_chunkColumns;
+			snapshot->m_chunks.reserve(chunks);
+			m_lastChunk.reset();
+
+			for (std::size_t index{}; index < chunks; index++) {
+				readChunk(map, snapshot->m_chunkColumns, static_cast<std::uint32_t>(index), m_buffer);
+				snapshot->m_chunks.push_back(makeChunk());
+			}
+
+			m_steps.clear();
+			m_steps.push_back({ snapshot, {} });
+			m_current = 0;
+			m_working = std::move(snapshot);
+			m_revision = map.revision();
+			m_pending.clear();
+		}
+
+		std::shared_ptr<const MapSnapshot> MapHistory::snapshot(const Map& map)
+		{
+			update(map);
+			return m_working;
+		}
+
+		bool MapHistory::commit(const Map& map)
+		{
+			update(map);
+
+			const auto& last = m_steps[m_current].snapshot;
+			if (m_working == last) return false;
+
+			std::sort(m_pending.begin(), m_pending.end());
+			m_pending.erase(std::unique(m_pending.begin(), m_pending.end()), m_pending.end());
+
+			Step step{};
+
+			for (std::uint32_t index : m_pending) {
+				if (*m_working->m_chunks[index] != *last->m_chunks[index]) step.changed.push_back(index);
+				// Edited back to how it was, share the old chunk again
+				else if (m_working->m_chunks[index] != last->m_chunks[index]) writable().m_chunks[index] = last->m_chunks[index];
+			}
+
+			m_pending.clear();
+
+			if (step.changed.empty() && m_working->m_start == last->m_start && m_working->m_finish == last->m_finish) {
+				m_working = last;
+				return false;
+			}
+
+			step.snapshot = m_working;
+
+			// A new step drops the ones that were undone
+			m_steps.erase(m_steps.begin() + m_current + 1, m_steps.end());
+			m_steps.push_back(std::move(step));
+			m_current++;
+			trim();
+
+			return true;
+		}
+
+		bool MapHistory::undo(Map& map)
+		{
+			commit(map);
+			if (!canUndo()) return false;
+
+			// The chunks the current step changed, as they were in the one before
+			moveTo(m_current - 1, m_steps[m_current].changed, map);
+			return true;
+		}
+
+		bool MapHistory::redo(Map& map)
+		{
+			commit(map);
+			if (!canRedo()) return false;
+
+			moveTo(m_current + 1, m_steps[m_current + 1].changed, map);
+			return true;
+		}
+
+		void MapHistory::setDepth(std::size_t steps)
+		{
+			m_depth = steps;
+			trim();
+		}
+
+		void MapHistory::trim()
+		{
+			while (m_current > m_depth) {
+				m_steps.pop_front();
+				m_current--;
+			}
+		}
+
+		void MapHistory::update(const Map& map)
+		{
+			// A map of another size starts a new history
+			if (!m_working || map.rows() != m_working->m_rows || map.columns() != m_working->m_columns) {
+				reset(map);
+				return;
+			}
+
+			if (map.revision() != m_revision) {
+				if (map.changesSince(m_revision, m_changed)) {
+					// Chunks of the edited tiles, each once
+					for (TileId& tile : m_changed) {
+						Position position = map.position(tile);
+						tile = static_cast<TileId>((position.row >> chunkShift) * m_working->m_chunkColumns + (position.column >> chunkShift));
+					}
+
+					std::sort(m_changed.begin(), m_changed.end());
+					m_changed.erase(std::unique(m_changed.begin(), m_changed.end()), m_changed.end());
+
+					for (std::uint32_t index : m_changed) refresh(map, index);
+				}
+				// A bulk edit, compare every chunk
+				else {
+					m_lastChunk.reset();
+					for (std::size_t index{}; index < m_working->m_chunks.size(); index++) refresh(map, static_cast<std::uint32_t>(index));
+				}
+
+				m_revision = map.revision();
+			}
+
+			if (map.start() != m_working->m_start || map.finish() != m_working->m_finish) {
+				MapSnapshot& working = writable();
+				working.m_start = map.start();
+				working.m_finish = map.finish();
+			}
+		}
+
+		MapSnapshot& MapHistory::writable()
+		{
+			// Held by a step or a reader, which must never see it change
+			if (m_working.use_count() > 1) m_working = std::make_shared<MapSnapshot>(*m_working);
+
+			return *m_working;
+		}
+
+		void MapHistory::refresh(const Map& map, std::uint32_t index)
+		{
+			readChunk(map, m_working->m_chunkColumns, index, m_buffer);
+			if (*m_working->m_chunks[index] == m_buffer) return;
+
+			writable().m_chunks[index] = makeChunk();
+			m_pending.push_back(index);
+		}
+
+		const std::shared_ptr<const MapSnapshot::Chunk>& MapHistory::makeChunk()
+		{
+			if (!m_lastChunk || *m_lastChunk != m_buffer) m_lastChunk = std::make_shared<const MapSnapshot::Chunk>(m_buffer);
+
+			return m_lastChunk;
+		}
+
+		void MapHistory::moveTo(std::size_t step, const std::vector<std::uint32_t>& chunks, Map& map)
+		{
+			m_steps[step].snapshot->restore(map, chunks);
+
+			m_current = step;
+			m_working = m_steps[step].snapshot;
+			m_revision = map.revision();
+			m_pending.clear();
+		}
+	}
+}
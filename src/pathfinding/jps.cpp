@@ -0,0 +1,195 @@
+#include "../../include/pathfinding/jps.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		// Is there an opening in the vertical direction that was walled off one tile behind
+		bool JumpPointEngine::isForced(TileId tile, int horizontal, std::int64_t vertical) const
+		{
+			return m_walkable.test(static_cast<TileId>(tile + vertical)) && !m_walkable.test(static_cast<TileId>(tile + vertical - horizontal));
+		}
+
+		TileId JumpPointEngine::jumpHorizontal(TileId tile, int direction) const
+		{
+			const std::int64_t stride = m_stride;
+			const std::int64_t finish = m_finish;
+
+			if (direction > 0) {
+				// Bit k of each window describes tile position + k
+				for (std::int64_t position = tile + 1;; position += 64) {
+					std::uint64_t open = m_walkable.window(position);
+					std::uint64_t up = m_walkable.window(position - stride) & ~m_walkable.window(position - stride - 1);
+					std::uint64_t down = m_walkable.window(position + stride) & ~m_walkable.window(position + stride - 1);
+					std::uint64_t stop = ~open | up | down;
+
+					if (static_cast<std::uint64_t>(finish - position) < 64) stop |= std::uint64_t{ 1 } << (finish - position);
+
+					if (stop) {
+						TileId found = static_cast<TileId>(position + countTrailingZeros(stop));
+						return m_walkable.test(found) ? found : invalidTile;
+					}
+				}
+			}
+
+			// Scanning left, the window ends at position so bit 63 is the nearest tile
+			for (std::int64_t position = tile - 1;; position -= 64) {
+				std::int64_t first = position - 63;
+				std::uint64_t open = m_walkable.window(first);
+				std::uint64_t up = m_walkable.window(first - stride) & ~m_walkable.window(first - stride + 1);
+				std::uint64_t down = m_walkable.window(first + stride) & ~m_walkable.window(first + stride + 1);
+				std::uint64_t stop = ~open | up | down;
+
+				if (static_cast<std::uint64_t>(position - finish) < 64) stop |= std::uint64_t{ 1 } << (63 - (position - finish));
+
+				if (stop) {
+					TileId found = static_cast<TileId>(first + 63 - countLeadingZeros(stop));
+					return m_walkable.test(found) ? found : invalidTile;
+				}
+			}
+		}
+
+		TileId JumpPointEngine::jumpVertical(TileId tile, std::int64_t direction) const
+		{
+			for (TileId current = static_cast<TileId>(tile + direction);; current = static_cast<TileId>(current + direction)) {
+				if (!m_walkable.test(current)) return invalidTile;
+				if (current == m_finish) return current;
+
+				// Turning horizontal is allowed anywhere, stop where it leads somewhere
+				if (jumpHorizontal(current, 1) != invalidTile || jumpHorizontal(current, -1) != invalidTile) return current;
+			}
+		}
+
+		void JumpPointEngine::relax(TileId from, TileId to)
+		{
+			if (to == invalidTile) return;
+
+			std::int64_t difference = std::abs(static_cast<std::int64_t>(to) - static_cast<std::int64_t>(from));
+			std::uint32_t distance = static_cast<std::uint32_t>(difference < m_stride ? difference : difference / m_stride);
+			std::uint32_t gCost = m_gCost[from] + distance;
+
+			if (m_state.isSeen(to)) {
+				if (m_state.isClosed(to) || gCost >= m_gCost[to]) return;
+			}
+			else m_state.open(to);
+
+			m_gCost[to] = gCost;
+			m_parent[to] = from;
+
+			std::uint32_t hCost = abs(static_cast<int>(to / m_stride) - m_finishRow) + abs(static_cast<int>(to % m_stride) - m_finishColumn);
+			m_open.push({ gCost + hCost, hCost, to });
+			m_pushed++;
+		}
+
+		void JumpPointEngine::fillPath(TileId start, std::vector<TileId>& path) const
+		{
+			path.clear();
+
+			// Walk jump points back to the start, adding the tiles skipped by each jump
+			for (TileId tile = m_finish; tile != start;) {
+				TileId parent = m_parent[tile];
+				std::int64_t difference = static_cast<std::int64_t>(tile) - static_cast<std::int64_t>(parent);
+				std::int64_t step = std::abs(difference) < m_stride ? (difference > 0 ? 1 : -1) : (difference > 0 ? m_stride : -m_stride);
+
+				for (std::int64_t between = tile - step; between != parent; between -= step) path.push_back(static_cast<TileId>(between));
+				if (parent != start) path.push_back(parent);
+
+				tile = parent;
+			}
+
+			// Reverse path to right way
+			std::reverse(path.begin(), path.end());
+		}
+
+		void JumpPointEngine::search(const Map& map, Position startTile, Position finishTile, SearchResult& result, SearchControl* control)
+		{
+			result.clear();
+
+			auto preprocess = std::chrono::steady_clock::now();
+
+			if (m_revision != map.revision()) {
+				if (map.changesSince(m_revision, m_changed)) {
+					for (TileId tile : m_changed) m_walkable.set(tile, map.isWalkable(tile));
+				}
+				else m_walkable.build(map);
+
+				m_revision = map.revision();
+			}
+
+			result.stats.preprocessSeconds = secondsSince(preprocess);
+
+			const TileId start = map.id(startTile);
+			m_finish = map.id(finishTile);
+			m_stride = map.stride();
+			m_finishRow = finishTile.row + 1;
+			m_finishColumn = finishTile.column + 1;
+
+			m_state.prepare(map.size());
+			if (m_gCost.size() != map.size()) {
+				m_gCost.resize(map.size());
+				m_parent.resize(map.size());
+			}
+
+			m_open.clear();
+
+			m_state.open(start);
+			m_gCost[start] = 0;
+			m_parent[start] = start;
+			m_open.push({ 0, 0, start });
+			m_pushed = 1;
+
+			while (!m_open.empty()) {
+				// Jumps push from inside relax, so the count is collected once per expansion
+				result.stats.pushed = m_pushed;
+				result.stats.peakOpen = std::max<std::uint64_t>(result.stats.peakOpen, m_open.size());
+
+				OpenNode current = m_open.pop();
+				const TileId tile = current.tile;
+
+				// A better copy of this tile was already expanded
+				if (m_state.isClosed(tile)) {
+					result.stats.stalePops++;
+					continue;
+				}
+				m_state.close(tile);
+
+				if (tile == m_finish) {
+					fillPath(start, result.path);
+					result.cost = m_gCost[tile];
+					result.found = true;
+					return;
+				}
+
+				result.stats.expanded++;
+
+				if (tile == start) {
+					relax(tile, jumpHorizontal(tile, 1));
+					relax(tile, jumpHorizontal(tile, -1));
+					relax(tile, jumpVertical(tile, -m_stride));
+					relax(tile, jumpVertical(tile, m_stride));
+					continue;
+				}
+
+				result.checked.push_back(tile);
+				if (!keepSearching(control, result.checked)) return;
+
+				std::int64_t difference = static_cast<std::int64_t>(tile) - static_cast<std::int64_t>(m_parent[tile]);
+
+				// Arrived horizontally, keep going and turn only into forced neighbours
+				if (std::abs(difference) < m_stride) {
+					int horizontal = difference > 0 ? 1 : -1;
+
+					relax(tile, jumpHorizontal(tile, horizontal));
+					if (isForced(tile, horizontal, -m_stride)) relax(tile, jumpVertical(tile, -m_stride));
+					if (isForced(tile, horizontal, m_stride)) relax(tile, jumpVertical(tile, m_stride));
+				}
+
+				// Arrived vertically, keep going or turn either way
+				else {
+					relax(tile, jumpVertical(tile, difference > 0 ? m_stride : -m_stride));
+					relax(tile, jumpHorizontal(tile, 1));
+					relax(tile, jumpHorizontal(tile, -1));
+				}
+			}
+		}
+	}
+}
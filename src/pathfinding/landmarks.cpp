@@ -0,0 +1,125 @@
+#include "../../include/pathfinding/landmarks.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		namespace {
+			// Tiles walked between cancellation checks while building
+			constexpr std::size_t cancelInterval{ 1 << 16 };
+		}
+
+		void LandmarkTable::setCount(std::size_t count)
+		{
+			if (count == m_requested) return;
+
+			m_requested = count;
+			m_built = false;
+		}
+
+		bool LandmarkTable::sync(const Map& map, SearchControl* control)
+		{
+			if (m_built && m_revision == map.revision() && m_distance.size() == map.size() * m_landmarks.size()) return true;
+
+			build(map, control);
+			return m_built;
+		}
+
+		void LandmarkTable::build(const Map& map, SearchControl* control)
+		{
+			const std::size_t columns = m_requested;
+
+			m_built = false;
+			m_landmarks.clear();
+			m_distance.assign(map.size() * columns, far);
+			m_nearest.assign(map.size(), ~std::uint32_t{});
+
+			// Seed from the walkable tile nearest the middle in scan order, it usually sits in the main area
+			const TileId middle = map.id(map.rows() / 2, map.columns() / 2);
+			TileId seed = invalidTile;
+
+			for (TileId tile = middle; tile < map.size() && seed == invalidTile; tile++)
+				if (map.isWalkable(tile)) seed = tile;
+			for (TileId tile{}; tile < middle && seed == invalidTile; tile++)
+				if (map.isWalkable(tile)) seed = tile;
+
+			if (seed != invalidTile && columns > 0) {
+				if (!walk(map, seed, columns, columns, control)) return;
+
+				// The last tile reached is the farthest from the seed
+				TileId next = m_queue.back();
+
+				while (m_landmarks.size() < columns) {
+					m_landmarks.push_back(next);
+					if (!walk(map, next, m_landmarks.size() - 1, columns, control)) return;
+
+					// Every landmark is in the seed's area, so the last walk reached the same tiles
+					std::uint32_t farthest{};
+					for (TileId tile : m_queue) {
+						if (m_nearest[tile] > farthest) {
+							farthest = m_nearest[tile];
+							next = tile;
+						}
+					}
+
+					// Every tile is a landmark already
+					if (farthest == 0) break;
+				}
+			}
+
+			// Close the gap left by landmarks that weren't placed
+			if (m_landmarks.size() < columns) {
+				const std::size_t placed = m_landmarks.size();
+
+				for (std::size_t tile{}; tile < map.size(); tile++)
+					for (std::size_t i{}; i < placed; i++) m_distance[tile * placed + i] = m_distance[tile * columns + i];
+
+				m_distance.resize(map.size() * placed);
+			}
+
+			m_revision = map.revision();
+			m_built = true;
+		}
+
+		bool LandmarkTable::walk(const Map& map, TileId source, std::size_t column, std::size_t columns, SearchControl* control)
+		{
+			const auto offsets = map.neighbourOffsets();
+			const std::uint8_t* cells = map.cells();
+
+			m_visited.prepare(map.size());
+			m_queue.clear();
+			m_queue.push_back(source);
+			m_visited.open(source);
+
+			std::uint32_t distance{};
+			std::size_t levelEnd{ 1 };
+
+			for (std::size_t head{}; head < m_queue.size(); head++) {
+				if (head == levelEnd) {
+					distance++;
+					levelEnd = m_queue.size();
+				}
+
+				if (head % cancelInterval == 0 && control && control->cancelled()) return false;
+
+				TileId current = m_queue[head];
+
+				// The seed walk only looks for the farthest tile
+				if (column < columns) {
+					m_distance[static_cast<std::size_t>(current) * columns + column] = static_cast<std::uint16_t>(std::min<std::uint32_t>(distance, far));
+					m_nearest[current] = std::min(m_nearest[current], distance);
+				}
+
+				for (auto offset : offsets) {
+					TileId next = static_cast<TileId>(current + offset);
+
+					if (cells[next] && !m_visited.isSeen(next)) {
+						m_visited.open(next);
+						m_queue.push_back(next);
+					}
+				}
+			}
+
+			return true;
+		}
+	}
+}
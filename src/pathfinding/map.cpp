@@ -0,0 +1,130 @@
+#include "../../include/pathfinding/map.h"
+
+#include <atomic>
+
+namespace engine {
+	namespace pathfinding {
+
+		namespace {
+			std::atomic<std::uint64_t> lastRevision{};
+		}
+
+		Map::Map(int rows, int columns) : m_rows{ rows }, m_columns{ columns }, m_stride{ columns + 2 }
+		{
+			assert(rows > 0 && columns > 0);
+			assert(rows <= maxDimension && columns <= maxDimension);
+
+			// Border tiles stay 0 forever
+			m_cells.assign(static_cast<std::size_t>(rows + 2) * m_stride, 0);
+			setAll(true);
+
+			// Initialise start and finish tiles
+			m_start = { 0, 0 };
+			m_finish = { rows - 1, columns - 1 };
+		}
+
+		bool Map::isInside(Position tile) const
+		{
+			return tile.row >= 0 && tile.row < m_rows
+				&& tile.column >= 0 && tile.column < m_columns;
+		}
+
+		void Map::setWalkable(Position tile, bool walkable)
+		{
+			assert(isInside(tile));
+
+			// Open tiles keep their terrain cost
+			if (isWalkable(id(tile)) != walkable) setCost(tile, walkable);
+		}
+
+		void Map::setCost(Position tile, std::uint8_t cost)
+		{
+			assert(isInside(tile));
+
+			if (m_cells[id(tile)] == cost) return;
+
+			// Drop the older half of the history when it's full
+			if (m_changes.size() >= maxChanges) m_changes.erase(m_changes.begin(), m_changes.begin() + maxChanges / 2);
+
+			m_changes.push_back({ m_revision, id(tile) });
+			m_cells[id(tile)] = cost;
+			touch();
+		}
+
+		std::uint64_t Map::pathCost(const std::vector<TileId>& path) const
+		{
+			std::uint64_t total = startId() == finishId() ? 0 : m_cells[finishId()];
+
+			for (TileId tile : path) total += m_cells[tile];
+
+			return total;
+		}
+
+		bool Map::changesSince(std::uint64_t revision, std::vector<TileId>& tiles) const
+		{
+			tiles.clear();
+
+			if (revision == m_revision) return true;
+
+			// Revisions only grow, so the history is sorted
+			auto change = std::lower_bound(m_changes.begin(), m_changes.end(), revision,
+				[](const Change& a, std::uint64_t b) { return a.revision < b; });
+
+			if (change == m_changes.end() || change->revision != revision) return false;
+
+			for (; change != m_changes.end(); change++) tiles.push_back(change->tile);
+			return true;
+		}
+
+		void Map::touch()
+		{
+			m_revision = ++lastRevision;
+		}
+
+		void Map::setAll(bool walkable)
+		{
+			for (int row{}; row < m_rows; row++) {
+				auto first = m_cells.begin() + id(row, 0);
+				std::fill(first, first + m_columns, static_cast<std::uint8_t>(walkable));
+			}
+
+			m_cells[startId()] = 1;
+			m_cells[finishId()] = 1;
+
+			// Bulk edits aren't recorded tile by tile
+			m_changes.clear();
+			touch();
+		}
+
+		void Map::clear()
+		{
+			setAll(true);
+		}
+
+		void Map::fill()
+		{
+			setAll(false);
+		}
+
+		void Map::randomize(int maxCoverage)
+		{
+			clear();
+
+			// Get random coverage
+			int coverage = rand() % maxCoverage + 1;
+
+			for (int row{}; row < m_rows; row++) {
+				for (int column{}; column < m_columns; column++) {
+					if (rand() % 100 + 1 < coverage) m_cells[id(row, column)] = 0;
+				}
+			}
+
+			m_cells[startId()] = 1;
+			m_cells[finishId()] = 1;
+
+			// Bulk edits aren't recorded tile by tile
+			m_changes.clear();
+			touch();
+		}
+	}
+}
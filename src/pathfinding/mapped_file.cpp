@@ -0,0 +1,103 @@
+#include "../../include/pathfinding/mapped_file.h"
+
+#include <algorithm>
+#include <utility>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace engine {
+	namespace pathfinding {
+
+		MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+		{
+			if (this == &other) return *this;
+
+			close();
+
+			m_data = std::exchange(other.m_data, nullptr);
+			m_size = std::exchange(other.m_size, 0);
+
+			return *this;
+		}
+
+		bool MappedFile::open(const std::string& path)
+		{
+			close();
+
+#ifdef _WIN32
+			HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE) return false;
+
+			LARGE_INTEGER size{};
+			HANDLE mapping = GetFileSizeEx(file, &size) && size.QuadPart > 0
+				? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+
+			// The view keeps the mapping alive on its own
+			if (mapping) {
+				m_data = static_cast<const std::uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+				m_size = m_data ? static_cast<std::size_t>(size.QuadPart) : 0;
+				CloseHandle(mapping);
+			}
+
+			CloseHandle(file);
+#else
+			int file = ::open(path.c_str(), O_RDONLY);
+			if (file < 0) return false;
+
+			struct stat status {};
+			if (fstat(file, &status) == 0 && status.st_size > 0) {
+				void* data = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+
+				if (data != MAP_FAILED) {
+					m_data = static_cast<const std::uint8_t*>(data);
+					m_size = static_cast<std::size_t>(status.st_size);
+				}
+			}
+
+			::close(file);
+#endif
+
+			return m_data != nullptr;
+		}
+
+		void MappedFile::close()
+		{
+			if (m_data) {
+#ifdef _WIN32
+				UnmapViewOfFile(m_data);
+#else
+				munmap(const_cast<std::uint8_t*>(m_data), m_size);
+#endif
+			}
+
+			m_data = nullptr;
+			m_size = 0;
+		}
+
+		void MappedFile::release(std::size_t offset, std::size_t size) const
+		{
+			if (!m_data || offset >= m_size) return;
+			size = std::min(size, m_size - offset);
+
+#ifdef _WIN32
+			// Unlocking pages that were never locked takes them out of the working set
+			VirtualUnlock(const_cast<std::uint8_t*>(m_data + offset), size);
+#else
+			// Only whole pages can be dropped, the chunked formats keep their blocks page aligned
+			const auto page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+			std::size_t first = (offset + page - 1) / page * page;
+			std::size_t last = (offset + size) / page * page;
+
+			if (first < last) madvise(const_cast<std::uint8_t*>(m_data + first), last - first, MADV_DONTNEED);
+#endif
+		}
+	}
+}
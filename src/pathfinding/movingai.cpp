@@ -0,0 +1,165 @@
+#include "../../include/pathfinding/movingai.h"
+
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cmath>
+
+namespace engine {
+	namespace pathfinding {
+
+		namespace {
+
+			bool isPassable(char tile)
+			{
+				return tile == '.' || tile == 'G' || tile == 'S';
+			}
+
+			// Header is "type", "height", "width" in any order, then "map", leaves the file at the first row
+			bool readHeader(std::ifstream& file, int& rows, int& columns)
+			{
+				std::string key{};
+
+				while (file >> key && key != "map") {
+					if (key == "height") file >> rows;
+					else if (key == "width") file >> columns;
+					else if (key == "type") file >> key;
+					else return false;
+				}
+
+				std::getline(file, key);
+				return file && rows > 0 && columns > 0;
+			}
+		}
+
+		bool loadMovingAiMap(const std::string& path, Map& map)
+		{
+			std::ifstream file{ path };
+			if (!file) return false;
+
+			int rows{}, columns{};
+			if (!readHeader(file, rows, columns) || rows > Map::maxDimension || columns > Map::maxDimension) return false;
+
+			Map loaded{ rows, columns };
+			std::string line{};
+
+			for (int row{}; row < rows; row++) {
+				if (!std::getline(file, line) || static_cast<int>(line.size()) < columns) return false;
+
+				for (int column{}; column < columns; column++) loaded.setWalkable({ row, column }, isPassable(line[column]));
+			}
+
+			map = std::move(loaded);
+			return true;
+		}
+
+		bool convertMovingAiMap(const std::string& mapPath, const std::string& chunkedPath)
+		{
+			std::ifstream file{ mapPath };
+			if (!file) return false;
+
+			int rows{}, columns{};
+			if (!readHeader(file, rows, columns)) return false;
+
+			ChunkedMapWriter writer{};
+			if (!writer.open(chunkedPath, rows, columns)) return false;
+
+			std::vector<std::uint8_t> band(static_cast<std::size_t>(ChunkedMap::chunkSize) * columns);
+			std::string line{};
+
+			for (int top{}; top < rows; top += ChunkedMap::chunkSize) {
+				int bandRows = std::min(ChunkedMap::chunkSize, rows - top);
+
+				for (int row{}; row < bandRows; row++) {
+					if (!std::getline(file, line) || static_cast<int>(line.size()) < columns) return false;
+
+					std::uint8_t* tiles = &band[static_cast<std::size_t>(row) * columns];
+					for (int column{}; column < columns; column++) tiles[column] = isPassable(line[column]);
+				}
+
+				if (!writer.writeBand(band.data(), bandRows)) return false;
+			}
+
+			return writer.close();
+		}
+
+		bool loadMovingAiScenarios(const std::string& path, std::vector<Scenario>& scenarios)
+		{
+			std::ifstream file{ path };
+			if (!file) return false;
+
+			std::string line{};
+
+			// Optional "version 1" header
+			if (file.peek() == 'v') std::getline(file, line);
+
+			scenarios.clear();
+
+			while (std::getline(file, line)) {
+				if (line.empty() || line == "\r") continue;
+
+				std::istringstream fields{ line };
+				Scenario scenario{};
+				int width{}, height{};
+
+				// Coordinates are x (column) first
+				if (!(fields >> scenario.bucket >> scenario.mapName >> width >> height
+					>> scenario.start.column >> scenario.start.row >> scenario.finish.column >> scenario.finish.row
+					>> scenario.optimalLength))
+					return false;
+
+				scenarios.push_back(std::move(scenario));
+			}
+
+			return true;
+		}
+
+		ScenarioReport runScenarios(Map& map, const std::vector<Scenario>& scenarios, PathfindingMethod method, Pathfinder& pathfinder)
+		{
+			ScenarioReport report{};
+			SearchResult result{};
+
+			for (const auto& scenario : scenarios) {
+				ScenarioOutcome outcome{};
+
+				if (!map.isValidTile(scenario.start) || !map.isValidTile(scenario.finish)) {
+					report.outcomes.push_back(outcome);
+					report.failed++;
+					continue;
+				}
+
+				map.setStart(scenario.start);
+				map.setFinish(scenario.finish);
+
+				const bool diagonal = movesDiagonally(method, pathfinder.movement());
+
+				if (diagonal) outcome.referenceLength = scenario.optimalLength;
+				else {
+					pathfinder.findPath(map, BreadthFirst, result);
+					outcome.referenceLength = result.found ? result.cost : -1;
+				}
+
+				auto begin = std::chrono::steady_clock::now();
+				pathfinder.findPath(map, method, result);
+				outcome.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+				outcome.found = result.found;
+				outcome.length = result.found ? result.cost : -1;
+				outcome.expanded = result.checked.size();
+				const double tolerance = 1e-4 * std::max(1.0, outcome.referenceLength);
+				outcome.valid = std::abs(outcome.length - outcome.referenceLength) < tolerance;
+
+				if (diagonal && pathfinder.movement() != Movement::EightConnectedNoCutting)
+					outcome.valid = outcome.found && outcome.length < outcome.referenceLength + tolerance;
+
+				report.seconds += outcome.seconds;
+				if (outcome.valid && outcome.found) report.solved++;
+				else if (!outcome.valid) report.failed++;
+
+				report.outcomes.push_back(outcome);
+			}
+
+			return report;
+		}
+	}
+}
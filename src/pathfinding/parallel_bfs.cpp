@@ -0,0 +1,206 @@
+#include "../../include/pathfinding/parallel_bfs.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		std::size_t ParallelBreadthFirstEngine::memoryUsage() const
+		{
+			std::size_t bytes = m_walkable.memoryUsage() + capacityBytes(m_changed) + m_visitedWords * sizeof(std::uint64_t) + capacityBytes(m_distance) + capacityBytes(m_frontier);
+
+			for (const auto& next : m_next) bytes += capacityBytes(next);
+
+			return bytes;
+		}
+
+		void ParallelBreadthFirstEngine::sync(const Map& map)
+		{
+			if (m_revision == map.revision()) return;
+
+			if (map.changesSince(m_revision, m_changed)) {
+				for (TileId tile : m_changed) {
+					bool walkable = map.isWalkable(tile);
+
+					if (m_walkable.test(tile) == walkable) continue;
+
+					m_walkable.set(tile, walkable);
+					walkable ? m_walkableCount++ : m_walkableCount--;
+				}
+			}
+			else {
+				m_walkable.build(map);
+				m_walkableCount = std::count_if(map.cells(), map.cells() + map.size(), [](std::uint8_t cell) { return cell != 0; });
+			}
+
+			m_revision = map.revision();
+		}
+
+		void ParallelBreadthFirstEngine::setThreads(std::size_t threads)
+		{
+			if (threads == m_threads) return;
+
+			m_threads = threads;
+			m_pool.reset();
+		}
+
+		void ParallelBreadthFirstEngine::forEachChunk(std::size_t count, const std::function<void(std::size_t)>& task)
+		{
+			if (count == 1 || !m_pool) {
+				for (std::size_t chunk{}; chunk < count; chunk++) task(chunk);
+				return;
+			}
+
+			m_pool->run(count, [&](std::size_t, std::size_t chunk) { task(chunk); });
+		}
+
+		void ParallelBreadthFirstEngine::topDown(std::size_t chunk, std::size_t chunkSize, std::uint32_t level)
+		{
+			std::vector<TileId>& next = m_next[chunk];
+			std::size_t end = std::min(m_frontier.size(), (chunk + 1) * chunkSize);
+
+			next.clear();
+
+			for (std::size_t i = chunk * chunkSize; i < end; i++) {
+				for (auto offset : m_offsets) {
+					TileId tile = static_cast<TileId>(m_frontier[i] + offset);
+					std::uint64_t bit = std::uint64_t{ 1 } << (tile & 63);
+
+					if (!m_cells[tile] || isVisited(tile)) continue;
+
+					// Whoever sets the bit first owns the tile
+					if (m_visited[tile >> 6].fetch_or(bit, std::memory_order_relaxed) & bit) continue;
+
+					m_distance[tile] = level + 1;
+					next.push_back(tile);
+				}
+			}
+		}
+
+		void ParallelBreadthFirstEngine::bottomUp(std::size_t chunk, std::size_t chunkWords, std::uint32_t level)
+		{
+			std::vector<TileId>& next = m_next[chunk];
+			std::size_t end = std::min(m_visitedWords, (chunk + 1) * chunkWords);
+
+			next.clear();
+
+			for (std::size_t word = chunk * chunkWords; word < end; word++) {
+				std::uint64_t open = m_walkable.window(static_cast<std::int64_t>(word * 64)) & ~m_visited[word].load(std::memory_order_relaxed);
+				std::uint64_t found{};
+
+				for (; open; open &= open - 1) {
+					TileId tile = static_cast<TileId>(word * 64 + countTrailingZeros(open));
+
+					for (auto offset : m_offsets) {
+						TileId neighbour = static_cast<TileId>(tile + offset);
+
+						// Other chunks publish their distances before the visited bits
+						if (isVisited(neighbour, std::memory_order_acquire) && m_distance[neighbour] == level) {
+							m_distance[tile] = level + 1;
+							found |= std::uint64_t{ 1 } << (tile & 63);
+							next.push_back(tile);
+							break;
+						}
+					}
+				}
+
+				// Only this chunk writes these bits, set them after the whole word so tiles found this level don't count as frontier
+				if (found) m_visited[word].fetch_or(found, std::memory_order_release);
+			}
+		}
+
+		void ParallelBreadthFirstEngine::search(const Map& map, Position startTile, Position finishTile, SearchResult& result, SearchControl* control)
+		{
+			result.clear();
+
+			const TileId start = map.id(startTile);
+			const TileId finish = map.id(finishTile);
+
+			if (start == finish) {
+				result.found = true;
+				return;
+			}
+
+			if (!m_pool && m_threads != 1) m_pool = std::make_unique<ThreadPool>(m_threads);
+
+			auto preprocess = std::chrono::steady_clock::now();
+			sync(map);
+			result.stats.preprocessSeconds = secondsSince(preprocess);
+
+			m_cells = map.cells();
+			m_offsets = map.neighbourOffsets();
+
+			std::size_t words = (map.size() + 63) / 64;
+			if (m_visitedWords != words) {
+				m_visited = std::make_unique<std::atomic<std::uint64_t>[]>(words);
+				m_visitedWords = words;
+				m_distance.resize(map.size());
+			}
+
+			for (std::size_t word{}; word < words; word++) m_visited[word].store(0, std::memory_order_relaxed);
+
+			m_visited[start >> 6].store(std::uint64_t{ 1 } << (start & 63), std::memory_order_relaxed);
+			m_distance[start] = 0;
+			m_frontier.assign(1, start);
+
+			std::size_t visitedCount{ 1 };
+			bool bottomUpMode{};
+			result.stats.pushed = 1;
+
+			for (std::uint32_t level{}; !m_frontier.empty() && !isVisited(finish); level++) {
+				for (TileId tile : m_frontier) if (tile != start) result.checked.push_back(tile);
+
+				if (!keepSearching(control, result.checked)) return;
+
+				// Each level is one frontier, expanded all at once
+				result.stats.expanded += m_frontier.size();
+				result.stats.peakOpen = std::max<std::uint64_t>(result.stats.peakOpen, m_frontier.size());
+
+				std::size_t unvisited = m_walkableCount > visitedCount ? m_walkableCount - visitedCount : 0;
+
+				if (!bottomUpMode && m_frontier.size() > unvisited / alpha && m_frontier.size() >= parallelFrontier) bottomUpMode = true;
+				else if (bottomUpMode && m_frontier.size() < m_walkableCount / beta) bottomUpMode = false;
+
+				std::size_t chunks{};
+
+				if (bottomUpMode) {
+					chunks = (words + bottomUpChunkWords - 1) / bottomUpChunkWords;
+					if (m_next.size() < chunks) m_next.resize(chunks);
+
+					forEachChunk(chunks, [&](std::size_t chunk) { bottomUp(chunk, bottomUpChunkWords, level); });
+				}
+				else {
+					std::size_t chunkSize = m_frontier.size() < parallelFrontier ? m_frontier.size() : topDownChunk;
+					chunks = (m_frontier.size() + chunkSize - 1) / chunkSize;
+					if (m_next.size() < chunks) m_next.resize(chunks);
+
+					forEachChunk(chunks, [&](std::size_t chunk) { topDown(chunk, chunkSize, level); });
+				}
+
+				m_frontier.clear();
+				for (std::size_t chunk{}; chunk < chunks; chunk++) m_frontier.insert(m_frontier.end(), m_next[chunk].begin(), m_next[chunk].end());
+
+				visitedCount += m_frontier.size();
+				result.stats.pushed += m_frontier.size();
+			}
+
+			if (!isVisited(finish)) return;
+
+			// Walk back down the distances
+			for (TileId tile = finish; m_distance[tile] > 1;) {
+				for (auto offset : m_offsets) {
+					TileId previous = static_cast<TileId>(tile + offset);
+
+					if (isVisited(previous) && m_distance[previous] + 1 == m_distance[tile]) {
+						tile = previous;
+						break;
+					}
+				}
+
+				result.path.push_back(tile);
+			}
+
+			std::reverse(result.path.begin(), result.path.end());
+			result.cost = m_distance[finish];
+			result.found = true;
+		}
+	}
+}
@@ -0,0 +1,140 @@
+#include "../../include/pathfinding/pathfinder.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		const char* methodName(PathfindingMethod method)
+		{
+			switch (method)
+			{
+			case BreadthFirst:
+				return "bfs";
+			case AStar:
+				return "astar";
+			case JumpPoint:
+				return "jps";
+			case BidirectionalBreadthFirst:
+				return "bibfs";
+			case BidirectionalAStar:
+				return "biastar";
+			case Hierarchical:
+				return "hpa";
+			case Incremental:
+				return "dstar";
+			case ParallelBreadthFirst:
+				return "pbfs";
+			case FloodFill:
+				return "flood";
+			case Landmarks:
+				return "alt";
+			case Dial:
+				return "dial";
+			default:
+				return "unknown";
+			}
+		}
+
+		const char* movementName(Movement movement)
+		{
+			switch (movement)
+			{
+			case Movement::FourConnected:
+				return "4";
+			case Movement::EightConnected:
+				return "8";
+			case Movement::EightConnectedNoSqueezing:
+				return "8-no-squeezing";
+			case Movement::EightConnectedNoCutting:
+				return "8-no-cutting";
+			default:
+				return "unknown";
+			}
+		}
+
+		const char* openListName(OpenListKind kind)
+		{
+			switch (kind)
+			{
+			case OpenListKind::BinaryHeap:
+				return "binary";
+			case OpenListKind::QuaternaryHeap:
+				return "4ary";
+			case OpenListKind::PairingHeap:
+				return "pairing";
+			case OpenListKind::Bucket:
+				return "bucket";
+			default:
+				return "unknown";
+			}
+		}
+
+		void Pathfinder::findPath(const Map& map, Position start, Position finish, PathfindingMethod method, SearchResult& result, SearchControl* control)
+		{
+			auto begin = std::chrono::steady_clock::now();
+			std::size_t memory{};
+
+			switch (method)
+			{
+			case BreadthFirst:
+				m_breadthFirst.search(map, start, finish, result, control);
+				memory = m_breadthFirst.memoryUsage();
+				break;
+			case AStar:
+				memory = withAStar([&](auto& engine) { engine.search(map, start, finish, result, control, m_movement); });
+				break;
+			case JumpPoint:
+				m_jumpPoint.search(map, start, finish, result, control);
+				memory = m_jumpPoint.memoryUsage();
+				break;
+			case BidirectionalBreadthFirst:
+				m_bidirectionalBreadthFirst.search(map, start, finish, result, control);
+				memory = m_bidirectionalBreadthFirst.memoryUsage();
+				break;
+			case BidirectionalAStar:
+				m_bidirectionalAStar.search(map, start, finish, result, control);
+				memory = m_bidirectionalAStar.memoryUsage();
+				break;
+			case Hierarchical:
+				m_hierarchical.search(map, start, finish, result, control);
+				memory = m_hierarchical.memoryUsage();
+				break;
+			case Incremental:
+				m_incremental.search(map, start, finish, result, control);
+				memory = m_incremental.memoryUsage();
+				break;
+			case ParallelBreadthFirst:
+				m_parallelBreadthFirst.search(map, start, finish, result, control);
+				memory = m_parallelBreadthFirst.memoryUsage();
+				break;
+			case FloodFill:
+				m_floodFill.search(map, start, finish, result, control);
+				memory = m_floodFill.memoryUsage();
+				break;
+			case Landmarks: {
+				// Building the table is part of the query, and can be cancelled like it
+				bool synced = m_landmarks.sync(map, control);
+				double preprocess = secondsSince(begin);
+
+				memory = withAStar([&](auto& engine) {
+					if (synced) engine.search(map, start, finish, m_landmarks, result, control);
+					else result.clear();
+				});
+
+				result.stats.preprocessSeconds = preprocess;
+				memory += m_landmarks.memoryUsage();
+				break;
+			}
+			case Dial:
+				m_dial.search(map, start, finish, result, control);
+				memory = m_dial.memoryUsage();
+				break;
+			default:
+				result = {};
+				return;
+			}
+
+			result.stats.peakMemory = memory;
+			result.stats.searchSeconds = secondsSince(begin) - result.stats.preprocessSeconds;
+		}
+	}
+}
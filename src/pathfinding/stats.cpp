@@ -0,0 +1,68 @@
+#include "../../include/pathfinding/stats.h"
+#include "../../include/pathfinding/pathfinder.h"
+
+#include <cstdio>
+#include <cinttypes>
+
+namespace engine {
+	namespace pathfinding {
+
+		SearchRecord makeRecord(const Map& map, PathfindingMethod method, const SearchResult& result)
+		{
+			SearchRecord record{};
+			record.method = method;
+			record.rows = map.rows();
+			record.columns = map.columns();
+			record.start = map.start();
+			record.finish = map.finish();
+			record.found = result.found;
+			record.pathLength = result.found && map.start() != map.finish() ? result.path.size() + 1 : 0;
+			record.cost = result.cost;
+			record.stats = result.stats;
+			return record;
+		}
+
+		bool writeStatsCsv(const std::string& path, const std::vector<SearchRecord>& records)
+		{
+			std::FILE* file = std::fopen(path.c_str(), "w");
+			if (!file) return false;
+
+			std::fprintf(file, "engine,rows,columns,start_row,start_column,finish_row,finish_column,found,path_length,cost,"
+				"expanded,pushed,stale_pops,peak_open,peak_memory_bytes,preprocess_seconds,search_seconds\n");
+
+			for (const SearchRecord& record : records) {
+				const SearchStats& stats = record.stats;
+
+				std::fprintf(file, "%s,%d,%d,%d,%d,%d,%d,%d,%zu,%.17g,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%.9f,%.9f\n",
+					methodName(record.method), record.rows, record.columns, record.start.row, record.start.column, record.finish.row, record.finish.column,
+					record.found ? 1 : 0, record.pathLength, record.cost, stats.expanded, stats.pushed, stats.stalePops, stats.peakOpen, stats.peakMemory,
+					stats.preprocessSeconds, stats.searchSeconds);
+			}
+
+			return std::fclose(file) == 0;
+		}
+
+		bool writeStatsJson(const std::string& path, const std::vector<SearchRecord>& records)
+		{
+			std::FILE* file = std::fopen(path.c_str(), "w");
+			if (!file) return false;
+
+			std::fprintf(file, "[");
+
+			for (std::size_t i{}; i < records.size(); i++) {
+				const SearchRecord& record = records[i];
+				const SearchStats& stats = record.stats;
+
+				std::fprintf(file, "%s\n  {\"engine\":\"%s\",\"rows\":%d,\"columns\":%d,\"start\":[%d,%d],\"finish\":[%d,%d],\"found\":%s,\"path_length\":%zu,\"cost\":%.17g,"
+					"\"expanded\":%" PRIu64 ",\"pushed\":%" PRIu64 ",\"stale_pops\":%" PRIu64 ",\"peak_open\":%" PRIu64 ",\"peak_memory_bytes\":%" PRIu64 ","
+					"\"phases\":{\"preprocess_seconds\":%.9f,\"search_seconds\":%.9f}}",
+					i ? "," : "", methodName(record.method), record.rows, record.columns, record.start.row, record.start.column, record.finish.row, record.finish.column,
+					record.found ? "true" : "false", record.pathLength, record.cost, stats.expanded, stats.pushed, stats.stalePops, stats.peakOpen, stats.peakMemory,
+					stats.preprocessSeconds, stats.searchSeconds);
+			}
+
+			std::fprintf(file, "\n]\n");
+			return std::fclose(file) == 0;
+		}
+	}
+}
@@ -0,0 +1,106 @@
+#include "../../include/pathfinding/thread_pool.h"
+
+namespace engine {
+	namespace pathfinding {
+
+		ThreadPool::ThreadPool(std::size_t threads)
+		{
+			if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+			for (std::size_t i{}; i < threads; i++) m_queues.push_back(std::make_unique<Queue>());
+			for (std::size_t i{}; i < threads; i++) m_threads.emplace_back([this, i] { work(i); });
+		}
+
+		ThreadPool::~ThreadPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock{ m_mutex };
+				m_stopping = true;
+			}
+
+			m_wake.notify_all();
+			for (auto& thread : m_threads) thread.join();
+		}
+
+		void ThreadPool::run(std::size_t count, const Task& task)
+		{
+			if (count == 0) return;
+
+			// Several ranges per worker leave something to steal near the end
+			std::size_t chunk = std::max<std::size_t>(1, count / (size() * 8));
+			std::size_t worker{};
+
+			m_remaining = count;
+
+			for (std::size_t begin{}; begin < count; begin += chunk) {
+				Queue& queue = *m_queues[worker];
+
+				std::lock_guard<std::mutex> lock{ queue.mutex };
+				queue.ranges.push_back({ &task, begin, std::min(begin + chunk, count) });
+
+				worker = (worker + 1) % size();
+			}
+
+			std::unique_lock<std::mutex> lock{ m_mutex };
+			m_batch++;
+			m_wake.notify_all();
+
+			m_done.wait(lock, [this] { return m_remaining == 0; });
+		}
+
+		bool ThreadPool::pop(std::size_t worker, Range& range)
+		{
+			Queue& queue = *m_queues[worker];
+			std::lock_guard<std::mutex> lock{ queue.mutex };
+
+			if (queue.ranges.empty()) return false;
+
+			range = queue.ranges.back();
+			queue.ranges.pop_back();
+			return true;
+		}
+
+		bool ThreadPool::steal(std::size_t worker, Range& range)
+		{
+			for (std::size_t i{ 1 }; i < size(); i++) {
+				Queue& queue = *m_queues[(worker + i) % size()];
+				std::lock_guard<std::mutex> lock{ queue.mutex };
+
+				if (queue.ranges.empty()) continue;
+
+				range = queue.ranges.front();
+				queue.ranges.pop_front();
+				return true;
+			}
+
+			return false;
+		}
+
+		void ThreadPool::work(std::size_t worker)
+		{
+			std::uint64_t batch{};
+
+			while (true) {
+				{
+					std::unique_lock<std::mutex> lock{ m_mutex };
+					m_wake.wait(lock, [&] { return m_stopping || m_batch != batch; });
+
+					if (m_stopping) return;
+					batch = m_batch;
+				}
+
+				Range range{};
+
+				while (pop(worker, range) || steal(worker, range)) {
+					for (std::size_t index = range.begin; index < range.end; index++) (*range.task)(worker, index);
+
+					// The last range wakes the caller
+					if (m_remaining.fetch_sub(range.end - range.begin) == range.end - range.begin) {
+						std::lock_guard<std::mutex> lock{ m_mutex };
+						m_done.notify_all();
+					}
+				}
+			}
+		}
+	}
+}
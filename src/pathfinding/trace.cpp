@@ -0,0 +1,336 @@
+#include "../../include/pathfinding/trace.h"
+
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+namespace engine {
+	namespace pathfinding {
+
+		namespace {
+
+			constexpr char magic[4]{ 'P', 'F', 'T', 'R' };
+			constexpr std::uint32_t version{ 2 };
+
+			/*
+				File layout, every section starts on an 8 byte boundary:
+				header, map costs, keyframes, path tiles, encoded steps.
+			*/
+			struct FileHeader
+			{
+				char magic[4]{};
+				std::uint32_t version{};
+				std::int32_t rows{};
+				std::int32_t columns{};
+				std::int32_t startRow{};
+				std::int32_t startColumn{};
+				std::int32_t finishRow{};
+				std::int32_t finishColumn{};
+				std::uint64_t steps{};
+				std::uint64_t keyframeCount{};
+				std::uint64_t byteCount{};
+				std::uint32_t pathLength{};
+				std::uint32_t keyframeInterval{};
+			};
+
+			std::size_t padded(std::size_t size) { return (size + 7) / 8 * 8; }
+
+			// Whether a tile id is a tile of a rows x columns map, the padding border isn't
+			bool isMapTile(std::int64_t tile, int rows, int columns)
+			{
+				const std::int64_t stride = columns + 2;
+				if (tile < 0) return false;
+
+				const std::int64_t row = tile / stride;
+				const std::int64_t column = tile % stride;
+				return row >= 1 && row <= rows && column >= 1 && column <= columns;
+			}
+
+			// Decode one keyframe block with bounds checks, it has to end where the next one starts
+			bool checkBlock(const TraceView& trace, std::size_t index)
+			{
+				const TraceKeyframe& keyframe = trace.keyframes[index];
+				const bool last = index + 1 == trace.keyframeCount;
+				const std::size_t end = last ? trace.byteCount : static_cast<std::size_t>(trace.keyframes[index + 1].offset);
+				const std::size_t steps = last ? trace.steps - index * traceKeyframeInterval : traceKeyframeInterval;
+
+				std::size_t offset = static_cast<std::size_t>(keyframe.offset);
+				TileId previous = keyframe.previous;
+
+				for (std::size_t step{}; step < steps; step++) {
+					std::uint64_t value{};
+					std::uint8_t byte{};
+
+					for (int shift{}; shift < 64; shift += 7) {
+						if (offset == end) return false;
+
+						byte = trace.bytes[offset++];
+						value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+						if (!(byte & 0x80)) break;
+					}
+
+					if (byte & 0x80) return false;
+
+					std::int64_t delta = static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+					std::int64_t tile = static_cast<std::int64_t>(previous) + delta;
+					if (!isMapTile(tile, trace.checks->rows, trace.checks->columns)) return false;
+
+					previous = static_cast<TileId>(tile);
+				}
+
+				return offset == end && (last || previous == trace.keyframes[index + 1].previous);
+			}
+		}
+
+		void TraceCursor::seek(const TraceView& trace, std::size_t step)
+		{
+			if (step < m_step || step - m_step > SearchTrace::keyframeInterval) {
+				*this = {};
+
+				if (trace.keyframeCount > 0) {
+					// The end of a trace can be past its last keyframe
+					std::size_t index = std::min(step / SearchTrace::keyframeInterval, trace.keyframeCount - 1);
+					const TraceKeyframe& keyframe = trace.keyframes[index];
+
+					m_step = index * SearchTrace::keyframeInterval;
+					m_offset = static_cast<std::size_t>(keyframe.offset);
+					m_previous = keyframe.previous;
+				}
+			}
+
+			while (m_step < step) next(trace);
+		}
+
+		void TraceCursor::enterBlock(const TraceView& trace)
+		{
+			const std::size_t index = m_step / traceKeyframeInterval;
+
+			// Past the last step, there's nothing to decode
+			if (index >= trace.keyframeCount) {
+				m_corrupt = true;
+				return;
+			}
+
+			auto& state = trace.checks->blocks[index];
+			if (state == TraceBlockChecks::Unchecked) state = checkBlock(trace, index) ? TraceBlockChecks::Valid : TraceBlockChecks::Corrupt;
+
+			// Start from the keyframe, the block before may have been corrupt
+			m_corrupt = state == TraceBlockChecks::Corrupt;
+			m_offset = static_cast<std::size_t>(trace.keyframes[index].offset);
+			m_previous = trace.keyframes[index].previous;
+		}
+
+		void SearchTrace::clear()
+		{
+			m_bytes.clear();
+			m_keyframes.clear();
+			m_steps = 0;
+			m_previous = 0;
+		}
+
+		void SearchTrace::append(TileId tile)
+		{
+			if (m_steps % keyframeInterval == 0) m_keyframes.push_back({ m_bytes.size(), m_previous, 0 });
+
+			// Zigzag keeps small negative differences small
+			std::int64_t delta = static_cast<std::int64_t>(tile) - m_previous;
+			std::uint64_t value = (static_cast<std::uint64_t>(delta) << 1) ^ static_cast<std::uint64_t>(delta >> 63);
+
+			while (value >= 0x80) {
+				m_bytes.push_back(static_cast<std::uint8_t>(value | 0x80));
+				value >>= 7;
+			}
+
+			m_bytes.push_back(static_cast<std::uint8_t>(value));
+			m_previous = tile;
+			m_steps++;
+		}
+
+		void SearchTrace::append(const TileId* tiles, std::size_t count)
+		{
+			for (std::size_t i{}; i < count; i++) append(tiles[i]);
+		}
+
+		bool writeTrace(const std::string& path, const Map& map, const TraceView& trace, const std::vector<TileId>& searchPath)
+		{
+			FileHeader header{};
+			std::memcpy(header.magic, magic, sizeof(magic));
+			header.version = version;
+			header.rows = map.rows();
+			header.columns = map.columns();
+			header.startRow = map.start().row;
+			header.startColumn = map.start().column;
+			header.finishRow = map.finish().row;
+			header.finishColumn = map.finish().column;
+			header.steps = trace.steps;
+			header.keyframeCount = trace.keyframeCount;
+			header.byteCount = trace.byteCount;
+			header.pathLength = static_cast<std::uint32_t>(searchPath.size());
+			header.keyframeInterval = static_cast<std::uint32_t>(SearchTrace::keyframeInterval);
+
+			// Row-major costs without the border
+			std::vector<std::uint8_t> cells(padded(static_cast<std::size_t>(map.rows()) * map.columns()));
+			for (int row{}; row < map.rows(); row++)
+				std::memcpy(&cells[static_cast<std::size_t>(row) * map.columns()], map.cells() + map.id(row, 0), map.columns());
+
+			std::FILE* file = std::fopen(path.c_str(), "wb");
+			if (!file) return false;
+
+			const std::uint64_t zero{};
+			std::size_t pathBytes = searchPath.size() * sizeof(TileId);
+
+			// Empty sections may come with null pointers
+			auto write = [file](const void* data, std::size_t size) { return size == 0 || std::fwrite(data, 1, size, file) == size; };
+
+			bool written = write(&header, sizeof(header))
+				&& write(cells.data(), cells.size())
+				&& write(trace.keyframes, trace.keyframeCount * sizeof(TraceKeyframe))
+				&& write(searchPath.data(), pathBytes)
+				&& write(&zero, padded(pathBytes) - pathBytes)
+				&& write(trace.bytes, trace.byteCount);
+
+			return std::fclose(file) == 0 && written;
+		}
+
+		MappedTrace& MappedTrace::operator=(MappedTrace&& other) noexcept
+		{
+			if (this == &other) return *this;
+
+			close();
+
+			m_file = std::move(other.m_file);
+			m_view = std::exchange(other.m_view, {});
+			m_path = std::move(other.m_path);
+			m_checks = std::move(other.m_checks);
+			m_cells = other.m_cells;
+			m_rows = other.m_rows;
+			m_columns = other.m_columns;
+			m_start = other.m_start;
+			m_finish = other.m_finish;
+
+			return *this;
+		}
+
+		bool MappedTrace::open(const std::string& path)
+		{
+			close();
+
+			if (!m_file.open(path) || m_file.size() < sizeof(FileHeader)) {
+				close();
+				return false;
+			}
+
+			const std::uint8_t* data = m_file.data();
+			const std::size_t size = m_file.size();
+
+			FileHeader header{};
+			std::memcpy(&header, data, sizeof(header));
+
+			bool valid = std::memcmp(header.magic, magic, sizeof(magic)) == 0 && header.version == version
+				&& header.keyframeInterval == SearchTrace::keyframeInterval
+				&& header.rows > 0 && header.rows <= Map::maxDimension && header.columns > 0 && header.columns <= Map::maxDimension
+				&& header.keyframeCount == (header.steps + SearchTrace::keyframeInterval - 1) / SearchTrace::keyframeInterval;
+
+			// Section sizes, checked against the file before anything is read from them
+			std::size_t cellSize = valid ? padded(static_cast<std::size_t>(header.rows) * header.columns) : 0;
+			std::size_t keyframeSize = static_cast<std::size_t>(header.keyframeCount) * sizeof(TraceKeyframe);
+			std::size_t pathSize = padded(static_cast<std::size_t>(header.pathLength) * sizeof(TileId));
+
+			valid = valid && header.keyframeCount <= size / sizeof(TraceKeyframe) && header.byteCount <= size
+				&& sizeof(header) + cellSize + keyframeSize + pathSize + header.byteCount == size;
+
+			if (!valid) {
+				close();
+				return false;
+			}
+
+			const std::uint8_t* section = data + sizeof(header);
+
+			m_rows = header.rows;
+			m_columns = header.columns;
+			m_start = { header.startRow, header.startColumn };
+			m_finish = { header.finishRow, header.finishColumn };
+			m_cells = section;
+			section += cellSize;
+
+			m_view.keyframes = reinterpret_cast<const TraceKeyframe*>(section);
+			m_view.keyframeCount = static_cast<std::size_t>(header.keyframeCount);
+			section += keyframeSize;
+
+			m_path.resize(header.pathLength);
+			if (!m_path.empty()) std::memcpy(m_path.data(), section, m_path.size() * sizeof(TileId));
+			section += pathSize;
+
+			m_view.bytes = section;
+			m_view.byteCount = static_cast<std::size_t>(header.byteCount);
+			m_view.steps = static_cast<std::size_t>(header.steps);
+
+			if (!validate()) {
+				close();
+				return false;
+			}
+
+			return true;
+		}
+
+		bool MappedTrace::validate()
+		{
+			Position corner{ m_rows - 1, m_columns - 1 };
+			auto isInside = [&](Position tile) { return tile.row >= 0 && tile.column >= 0 && tile.row <= corner.row && tile.column <= corner.column; };
+
+			if (!isInside(m_start) || !isInside(m_finish)) return false;
+
+			// Every tile has to be a tile of the map, a border tile has no position to draw it at
+			for (TileId tile : m_path)
+				if (!isMapTile(tile, m_rows, m_columns)) return false;
+
+			// Keyframes are where blocks start decoding, the steps between them are checked as replay reaches them
+			std::uint64_t offset{};
+
+			for (std::size_t index{}; index < m_view.keyframeCount; index++) {
+				const TraceKeyframe& keyframe = m_view.keyframes[index];
+
+				if (keyframe.offset < offset || keyframe.offset > m_view.byteCount) return false;
+				// The first block counts from tile 0, the others from the last tile of the block before
+				if (index == 0 && (keyframe.offset != 0 || keyframe.previous != 0)) return false;
+				if (index > 0 && !isMapTile(keyframe.previous, m_rows, m_columns)) return false;
+
+				offset = keyframe.offset;
+			}
+
+			m_checks = std::make_unique<TraceBlockChecks>();
+			m_checks->blocks.assign(m_view.keyframeCount, TraceBlockChecks::Unchecked);
+			m_checks->rows = m_rows;
+			m_checks->columns = m_columns;
+			// The start is inside the map, so replay of a corrupt block stays on it
+			m_checks->fallback = static_cast<TileId>((m_start.row + 1) * (m_columns + 2) + m_start.column + 1);
+
+			return true;
+		}
+
+		void MappedTrace::close()
+		{
+			m_file.close();
+			m_view = {};
+			m_path.clear();
+			m_checks.reset();
+			m_cells = nullptr;
+		}
+
+		Map MappedTrace::map() const
+		{
+			Map map{ m_rows, m_columns };
+
+			for (int row{}; row < m_rows; row++) {
+				for (int column{}; column < m_columns; column++) {
+					std::uint8_t cost = m_cells[static_cast<std::size_t>(row) * m_columns + column];
+					if (cost != 1) map.setCost({ row, column }, cost);
+				}
+			}
+
+			map.setStart(m_start);
+			map.setFinish(m_finish);
+			return map;
+		}
+	}
+}
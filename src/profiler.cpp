@@ -0,0 +1,256 @@
+#include "../include/profiler.h"
+#include "../include/window.h"
+#include "../include/settings.h"
+#include "../include/ui.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace engine {
+	namespace profiler {
+
+		bool graphVisible{};
+
+#ifdef PATHFINDING_PROFILER
+		namespace {
+
+			using Clock = std::chrono::steady_clock;
+
+			struct Event
+			{
+				const char* name{};
+				// Nanoseconds since the profiler started, duration is negative while the scope is open
+				std::int64_t start{};
+				std::int64_t duration{ -1 };
+				int depth{};
+			};
+
+			struct Frame
+			{
+				std::int64_t start{};
+				std::int64_t duration{};
+				std::vector<Event> events{};
+			};
+
+			// Top level scope, with its colour in the graph and its line in the legend
+			struct Subsystem
+			{
+				const char* name{};
+				sf::Color color{};
+				tgui::Label::Ptr label{};
+			};
+
+			const Clock::time_point origin{ Clock::now() };
+
+			// Ring of frames, current is the one being recorded
+			std::array<Frame, frameCount> frames{};
+			std::size_t current{};
+			// Closed frames in the ring, the first frame opens at the first beginFrame
+			std::size_t recorded{};
+			bool started{};
+			// Events of the current frame that haven't ended yet
+			std::vector<std::size_t> openEvents{};
+
+			std::vector<Subsystem> subsystems{};
+			const std::array<sf::Color, 8> palette{ sf::Color{ 66, 135, 245 }, sf::Color{ 245, 166, 35 }, sf::Color{ 80, 200, 120 }, sf::Color{ 230, 80, 80 },
+				sf::Color{ 170, 110, 230 }, sf::Color{ 60, 200, 210 }, sf::Color{ 240, 120, 200 }, sf::Color{ 190, 190, 60 } };
+			const sf::Color untrackedColor{ 120, 120, 120 };
+
+			tgui::Label::Ptr summary{};
+			std::vector<sf::Vertex> graph{};
+
+			// Graph in the margin right of the grid, one pixel column per frame, twice the frame budget high
+			constexpr float graphHeight{ 200 };
+			sf::Vector2f graphPosition{};
+			constexpr double frameBudget{ 1e9 / settings::fps };
+
+			std::int64_t now()
+			{
+				return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - origin).count();
+			}
+
+			// Oldest closed frame first
+			const Frame& closedFrame(std::size_t index)
+			{
+				return frames[(current + frameCount - recorded + index) % frameCount];
+			}
+
+			Subsystem& subsystem(const char* name)
+			{
+				for (auto& known : subsystems)
+					if (std::strcmp(known.name, name) == 0) return known;
+
+				Subsystem added{ name, palette[subsystems.size() % palette.size()] };
+				added.label = tgui::Label::create();
+				added.label->setTextSize(14);
+				added.label->getRenderer()->setTextColor(added.color);
+				added.label->setPosition({ graphPosition.x, graphPosition.y + graphHeight + 30 + subsystems.size() * 20.f });
+				added.label->setVisible(graphVisible);
+				ui::gui.add(added.label);
+
+				subsystems.push_back(added);
+				return subsystems.back();
+			}
+
+			void addRect(float left, float top, float width, float height, const sf::Color& color)
+			{
+				sf::Vector2f corners[4]{ { left, top }, { left + width, top }, { left + width, top + height }, { left, top + height } };
+
+				for (int corner : { 0, 1, 2, 0, 2, 3 }) graph.emplace_back(corners[corner], color);
+			}
+		}
+
+		void initialize()
+		{
+			graphPosition = { settings::windowSize.x - (settings::windowSize.x - settings::gridSize.x) / 2 + 5, settings::windowSize.y * 0.55f - settings::gridSize.y / 2 };
+
+			summary = tgui::Label::create();
+			summary->setTextSize(14);
+			summary->getRenderer()->setTextColor(sf::Color::Black);
+			summary->setPosition({ graphPosition.x, graphPosition.y + graphHeight + 5 });
+			summary->setVisible(graphVisible);
+			ui::gui.add(summary);
+		}
+
+		void beginFrame()
+		{
+			std::int64_t time = now();
+			Frame& frame = frames[current];
+
+			// Scopes left open by an early return end with the frame
+			for (std::size_t index : openEvents) frame.events[index].duration = time - frame.events[index].start;
+			openEvents.clear();
+
+			if (started) {
+				frame.duration = time - frame.start;
+				current = (current + 1) % frameCount;
+				recorded = std::min(recorded + 1, frameCount - 1);
+			}
+
+			started = true;
+
+			Frame& next = frames[current];
+			next.start = time;
+			next.duration = 0;
+			next.events.clear();
+		}
+
+		void begin(const char* name)
+		{
+			auto& events = frames[current].events;
+
+			openEvents.push_back(events.size());
+			events.push_back({ name, now(), -1, static_cast<int>(openEvents.size()) - 1 });
+		}
+
+		void end()
+		{
+			if (openEvents.empty()) return;
+
+			Event& event = frames[current].events[openEvents.back()];
+			event.duration = now() - event.start;
+			openEvents.pop_back();
+		}
+
+		void toggleGraph()
+		{
+			graphVisible = !graphVisible;
+
+			if (summary) summary->setVisible(graphVisible);
+			for (auto& known : subsystems) known.label->setVisible(graphVisible);
+		}
+
+		void render()
+		{
+			if (!graphVisible) return;
+
+			const float scale = static_cast<float>(graphHeight / (2 * frameBudget));
+			const float bottom = graphPosition.y + graphHeight;
+
+			graph.clear();
+			addRect(graphPosition.x, graphPosition.y, frameCount, graphHeight, sf::Color{ 0, 0, 0, 40 });
+
+			std::vector<double> totals(subsystems.size());
+			std::int64_t worst{};
+			double average{};
+
+			for (std::size_t index{}; index < recorded; index++) {
+				const Frame& frame = closedFrame(index);
+				// Newest frame on the right
+				float x = graphPosition.x + (frameCount - recorded) + index;
+				float top = bottom;
+
+				for (const Event& event : frame.events) {
+					if (event.depth != 0) continue;
+
+					Subsystem& owner = subsystem(event.name);
+					float height = std::min(event.duration * scale, top - graphPosition.y);
+
+					addRect(x, top - height, 1, height, owner.color);
+					top -= height;
+
+					totals.resize(subsystems.size());
+					totals[&owner - subsystems.data()] += event.duration;
+				}
+
+				// Whatever no scope covered, mostly the main loop itself
+				float rest = std::min(frame.duration * scale - (bottom - top), top - graphPosition.y);
+				if (rest > 0) addRect(x, top - rest, 1, rest, untrackedColor);
+
+				worst = std::max(worst, frame.duration);
+				average += frame.duration;
+			}
+
+			// The frame budget at the target frame rate
+			addRect(graphPosition.x, bottom - static_cast<float>(frameBudget) * scale, frameCount, 1, sf::Color::Red);
+
+			engine::window::windowPtr->draw(graph.data(), graph.size(), sf::Triangles);
+
+			// Averages over the recorded frames
+			char text[128]{};
+			std::snprintf(text, sizeof(text), "Frame %.2f ms, worst %.2f ms", recorded ? average / recorded / 1e6 : 0.0, worst / 1e6);
+			summary->setText(text);
+
+			for (std::size_t i{}; i < subsystems.size(); i++) {
+				std::snprintf(text, sizeof(text), "%s %.2f ms", subsystems[i].name, recorded ? totals[i] / recorded / 1e6 : 0.0);
+				subsystems[i].label->setText(text);
+			}
+		}
+
+		bool exportTrace(const std::string& path)
+		{
+			std::FILE* file = std::fopen(path.c_str(), "w");
+			if (!file) return false;
+
+			// Complete ("X") events in microseconds, everything on the main thread
+			std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+			const char* separator = "";
+
+			for (std::size_t index{}; index < recorded; index++) {
+				const Frame& frame = closedFrame(index);
+
+				std::fprintf(file, "%s\n{\"name\":\"frame\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1}", separator, frame.start / 1e3, frame.duration / 1e3);
+				separator = ",";
+
+				for (const Event& event : frame.events) {
+					if (event.duration < 0) continue;
+
+					std::fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1}", event.name, event.start / 1e3, event.duration / 1e3);
+				}
+			}
+
+			std::fprintf(file, "\n]}\n");
+			return std::fclose(file) == 0;
+		}
+#else
+		void initialize() {}
+		void beginFrame() {}
+		void begin(const char*) {}
+		void end() {}
+		void toggleGraph() {}
+		void render() {}
+		bool exportTrace(const std::string&) { return false; }
+#endif
+	}
+}
@@ -3,6 +3,8 @@
 #include "../include/settings.h"
 #include "../include/grid.h"
 
+#include <cstdio>
+
 namespace engine {
 	namespace ui {
 
@@ -14,27 +16,45 @@ namespace engine {
 		tgui::VerticalLayout::Ptr titleWrapper;
 		tgui::Label::Ptr titleText;
 		tgui::VerticalLayout::Ptr algorithmWrapper;
+		tgui::HorizontalLayout::Ptr algorithmHeader;
 		tgui::Label::Ptr algorithmText;
+		tgui::Button::Ptr statsButton;
 		tgui::ComboBox::Ptr algorithmSelector;
+		tgui::CheckBox::Ptr diagonalCheckBox;
 		tgui::VerticalLayout::Ptr speedWrapper;
+		tgui::HorizontalLayout::Ptr speedHeader;
 		tgui::Label::Ptr speedText;
+		tgui::Button::Ptr skipButton;
 		tgui::Slider::Ptr speedSlider;
 		tgui::VerticalLayout::Ptr audioWrapper;
 		tgui::Label::Ptr audioText;
 		tgui::Slider::Ptr audioSlider;
+		tgui::VerticalLayout::Ptr brushWrapper;
+		tgui::Label::Ptr brushText;
+		tgui::Slider::Ptr brushSlider;
 		tgui::BitmapButton::Ptr startButton;
 		tgui::VerticalLayout::Ptr buttonsWrapper;
 		tgui::Button::Ptr clearGridButton;
 		tgui::Button::Ptr fillGridButton;
 		tgui::Button::Ptr randomGridButton;
 		tgui::SeparatorLine::Ptr line;
+		tgui::HorizontalLayout::Ptr timelineWrapper;
+		tgui::Label::Ptr timelineText;
+		tgui::Slider::Ptr timelineSlider;
+		tgui::Panel::Ptr statsPanel;
+		tgui::Label::Ptr statsText;
+		tgui::Button::Ptr exportJsonButton;
+		tgui::Button::Ptr exportCsvButton;
 
 		bool inProcess{};
 
+		// Set while the grid moves the timeline, so it isn't taken for the user seeking
+		static bool updatingTimeline{};
+
 		void initialize()
 		{
 			layout = tgui::HorizontalWrap::create();
-			layout->setSize({ 1600, 75 });
+			layout->setSize({ 1820, 75 });
 			layout->setPosition({settings::windowSize.x / 2 - layout->getSize().x / 2, 50});
 			layout->getRenderer()->setSpaceBetweenWidgets(20);
 			gui.add(layout);
@@ -53,33 +73,69 @@ namespace engine {
 			algorithmWrapper->setSize({200, 80 });
 			layout->add(algorithmWrapper);
 
+			algorithmHeader = tgui::HorizontalLayout::create();
+			algorithmWrapper->add(algorithmHeader);
+
 			algorithmText = tgui::Label::create("Algorithm");
 			algorithmText->setTextSize(20);
-			algorithmWrapper->add(algorithmText);
+			algorithmHeader->add(algorithmText);
+
+			statsButton = tgui::Button::create();
+			statsButton->setText("Stats");
+			statsButton->getRenderer()->setTextSize(15);
+			statsButton->onClick([] { statsPanel->setVisible(!statsPanel->isVisible()); });
+			algorithmHeader->add(statsButton, 0.35f);
 
 			algorithmSelector = tgui::ComboBox::create();
 			algorithmSelector->getRenderer()->setTextSize(15);
 			algorithmSelector->addItem("Breadth First Search");
 			algorithmSelector->addItem("A* Search");
+			algorithmSelector->addItem("Jump Point Search");
+			algorithmSelector->addItem("Bidirectional BFS");
+			algorithmSelector->addItem("Bidirectional A*");
+			algorithmSelector->addItem("Hierarchical A*");
+			algorithmSelector->addItem("D* Lite (live replanning)");
+			algorithmSelector->addItem("Parallel BFS");
+			algorithmSelector->addItem("Bitboard flood fill");
+			algorithmSelector->addItem("A* with landmarks (ALT)");
+			algorithmSelector->addItem("Dial A* (terrain costs)");
 			algorithmSelector->setSelectedItemByIndex(0);
 
 			algorithmWrapper->add(algorithmSelector);
-			algorithmWrapper->addSpace(0.8);
+
+			// Diagonal moves never cut corners, the rule MovingAI scenarios use
+			diagonalCheckBox = tgui::CheckBox::create("Diagonal moves (A*)");
+			diagonalCheckBox->setTextSize(15);
+			diagonalCheckBox->onCheck([] { engine::grid.setMovement(engine::pathfinding::Movement::EightConnectedNoCutting); });
+			diagonalCheckBox->onUncheck([] { engine::grid.setMovement(engine::pathfinding::Movement::FourConnected); });
+			algorithmWrapper->add(diagonalCheckBox);
 
 			speedWrapper = tgui::VerticalLayout::create();
 			speedWrapper->setSize({ 200, 80 });
 			layout->add(speedWrapper);
 
-			speedText = tgui::Label::create("Speed");
+			speedHeader = tgui::HorizontalLayout::create();
+			speedWrapper->add(speedHeader);
+
+			speedText = tgui::Label::create();
 			speedText->setTextSize(20);
-			speedWrapper->add(speedText);
+			speedHeader->add(speedText);
+
+			skipButton = tgui::Button::create();
+			skipButton->setText("Skip");
+			skipButton->getRenderer()->setTextSize(15);
+			skipButton->onClick(&engine::Grid::skipAnimation, &engine::grid);
+			speedHeader->add(skipButton, 0.35f);
 
+			// Power of ten tiles per second
 			speedSlider = tgui::Slider::create();
 			speedSlider->setMinimum(0);
-			speedSlider->setMaximum(2);
+			speedSlider->setMaximum(6);
 			speedSlider->setStep(0.1);
-			speedSlider->setValue(1);
+			speedSlider->onValueChange(&updateSpeedText);
+			speedSlider->setValue(2);
 			speedWrapper->add(speedSlider);
+			updateSpeedText();
 			speedWrapper->addSpace(0.3);
 
 			audioWrapper = tgui::VerticalLayout::create();
@@ -98,6 +154,25 @@ namespace engine {
 			audioWrapper->add(audioSlider);
 			audioWrapper->addSpace(0.3);
 
+			// What left drag paints, 0 is an obstacle and anything else the cost of walking onto the tile
+			brushWrapper = tgui::VerticalLayout::create();
+			brushWrapper->setSize({ 200, 80 });
+			layout->add(brushWrapper);
+
+			brushText = tgui::Label::create();
+			brushText->setTextSize(20);
+			brushWrapper->add(brushText);
+
+			brushSlider = tgui::Slider::create();
+			brushSlider->setMinimum(0);
+			brushSlider->setMaximum(pathfinding::Map::maxCost);
+			brushSlider->setStep(1);
+			brushSlider->setValue(0);
+			brushSlider->onValueChange(&updateBrushText);
+			brushWrapper->add(brushSlider);
+			updateBrushText();
+			brushWrapper->addSpace(0.3);
+
 			startButton = tgui::BitmapButton::create();
 			startButton->setSize({60, 60});
 			startButton->getRenderer()->setBackgroundColor(sf::Color::Green);
@@ -142,6 +217,56 @@ namespace engine {
 			line->setSize({"100%", 2});
 			line->setPosition({0, layout->getPosition().y + layout->getSize().y});
 			gui.add(line);
+
+			timelineWrapper = tgui::HorizontalLayout::create();
+			timelineWrapper->setSize({ settings::gridSize.x, 30 });
+			timelineWrapper->setPosition({ settings::windowSize.x / 2 - settings::gridSize.x / 2, 1015 });
+			gui.add(timelineWrapper);
+
+			timelineSlider = tgui::Slider::create();
+			timelineSlider->setMinimum(0);
+			timelineSlider->setMaximum(100000);
+			timelineSlider->setStep(1);
+			timelineSlider->onValueChange([] {
+				if (!updatingTimeline) engine::grid.seek(timelineSlider->getValue() / timelineSlider->getMaximum());
+			});
+			timelineWrapper->add(timelineSlider);
+			timelineWrapper->addSpace(0.05f);
+
+			timelineText = tgui::Label::create();
+			timelineText->setTextSize(18);
+			timelineWrapper->add(timelineText, 0.2f);
+			updateTimeline(0, 0);
+
+			// Hidden until the stats button is pressed, drawn over the top left of the grid under the algorithm selector
+			statsPanel = tgui::Panel::create();
+			statsPanel->setSize({ 260, 270 });
+			statsPanel->setPosition({ layout->getPosition().x + algorithmWrapper->getPosition().x, settings::windowSize.y * 0.55f - settings::gridSize.y / 2 + 10 });
+			statsPanel->getRenderer()->setBackgroundColor(sf::Color::Color(40, 40, 40, 220));
+			statsPanel->setVisible(false);
+			gui.add(statsPanel);
+
+			auto statsLayout = tgui::VerticalLayout::create();
+			statsLayout->setSize({ "100%", "100%" });
+			statsPanel->add(statsLayout);
+
+			statsText = tgui::Label::create("No search finished yet");
+			statsText->setTextSize(15);
+			statsLayout->add(statsText, 0.85f);
+
+			auto exportButtons = tgui::HorizontalLayout::create();
+			statsLayout->add(exportButtons, 0.15f);
+
+			exportJsonButton = tgui::Button::create();
+			exportJsonButton->setText("Export JSON");
+			exportJsonButton->getRenderer()->setTextSize(13);
+			exportJsonButton->onClick([] { engine::grid.exportStats("search_stats.json"); });
+			exportButtons->add(exportJsonButton);
+
+			exportCsvButton = tgui::Button::copy(exportJsonButton);
+			exportCsvButton->setText("Export CSV");
+			exportCsvButton->onClick([] { engine::grid.exportStats("search_stats.csv"); });
+			exportButtons->add(exportCsvButton);
 		}
 
 		void onStartButtonClick()
@@ -154,6 +279,41 @@ namespace engine {
 			updateButton();
 		}
 
+		void updateSpeedText()
+		{
+			speedText->setText("Speed " + std::to_string(static_cast<long long>(std::round(std::pow(10.0, speedSlider->getValue())))) + "/s");
+		}
+
+		void updateBrushText()
+		{
+			int cost = static_cast<int>(brushSlider->getValue());
+			brushText->setText(cost == 0 ? "Brush: obstacle" : "Brush: cost " + std::to_string(cost));
+		}
+
+		void showStats(const engine::pathfinding::SearchRecord& record, std::size_t recorded)
+		{
+			const auto& stats = record.stats;
+			char text[512]{};
+
+			std::snprintf(text, sizeof(text),
+				"%s on %dx%d\n%s\nExpanded: %llu\nPushed: %llu\nStale pops: %llu\nPeak open: %llu\nMemory: %.1f MB\nPreprocess: %.2f ms\nSearch: %.2f ms\nRecorded searches: %zu",
+				engine::pathfinding::methodName(record.method), record.rows, record.columns,
+				record.found ? ("Path: " + std::to_string(record.pathLength) + " moves, cost " + std::to_string(static_cast<long long>(record.cost))).c_str() : "No path",
+				static_cast<unsigned long long>(stats.expanded), static_cast<unsigned long long>(stats.pushed), static_cast<unsigned long long>(stats.stalePops),
+				static_cast<unsigned long long>(stats.peakOpen), stats.peakMemory / (1024.0 * 1024.0), stats.preprocessSeconds * 1000, stats.searchSeconds * 1000, recorded);
+
+			statsText->setText(text);
+		}
+
+		void updateTimeline(std::size_t revealed, std::size_t steps)
+		{
+			updatingTimeline = true;
+			timelineSlider->setValue(steps ? static_cast<float>(static_cast<double>(revealed) / steps * timelineSlider->getMaximum()) : 0.f);
+			updatingTimeline = false;
+
+			timelineText->setText(std::to_string(revealed) + " / " + std::to_string(steps));
+		}
+
 		void setProcessState(bool state)
 		{
 			inProcess = state;
@@ -2,6 +2,7 @@
 #include "../include/ui.h"
 #include "../include/grid.h"
 #include "../include/settings.h"
+#include "../include/profiler.h"
 
 namespace engine {
 	namespace window {
@@ -10,7 +11,8 @@ namespace engine {
 		std::unique_ptr<sf::RenderWindow> windowPtr{};
 		sf::Vector2i mousePos{};
 		sf::Image icon{};
-		float animationFrame{};
+		sf::Clock frameClock{};
+		float frameTime{};
 		float animationSpeed{};
 
 		void create() {
@@ -46,6 +48,34 @@ namespace engine {
 						windowPtr->close();
 						break;
 
+					case sf::Keyboard::Space:
+						engine::grid.skipAnimation();
+						break;
+
+					// Frame time graph and its export, only there when profiling is compiled in
+					case sf::Keyboard::F3:
+						engine::profiler::toggleGraph();
+						break;
+
+					case sf::Keyboard::F4:
+						engine::profiler::exportTrace("frame_trace.json");
+						break;
+
+					// Save the shown search next to the executable
+					case sf::Keyboard::S:
+						if (event.key.control) engine::grid.saveTrace("search.trace");
+						break;
+
+					// Undo with Ctrl+Z, redo with Ctrl+Y or Ctrl+Shift+Z
+					case sf::Keyboard::Z:
+						if (event.key.control && event.key.shift) engine::grid.redo();
+						else if (event.key.control) engine::grid.undo();
+						break;
+
+					case sf::Keyboard::Y:
+						if (event.key.control) engine::grid.redo();
+						break;
+
 					case sf::Keyboard::Enter:
 						engine::ui::onStartButtonClick();
 					default:
@@ -68,6 +98,10 @@ namespace engine {
 					if (event.mouseButton.button == sf::Mouse::Right) {
 						engine::grid.rightClick();
 					}
+
+					if (event.mouseButton.button == sf::Mouse::Middle) {
+						engine::grid.middleClick(sf::Vector2i{ event.mouseButton.x, event.mouseButton.y });
+					}
 				}
 
 				// Mouse release events
@@ -79,13 +113,24 @@ namespace engine {
 					if (event.mouseButton.button == sf::Mouse::Right) {
 						engine::grid.rightReleased();
 					}
+
+					if (event.mouseButton.button == sf::Mouse::Middle) {
+						engine::grid.middleReleased();
+					}
+				}
+
+				// Zoom the grid
+				if (event.type == sf::Event::MouseWheelScrolled && event.mouseWheelScroll.wheel == sf::Mouse::VerticalWheel) {
+					engine::grid.zoom(event.mouseWheelScroll.delta, sf::Vector2i{ event.mouseWheelScroll.x, event.mouseWheelScroll.y });
 				}
 				
 				// Handle ui events
 				engine::ui::gui.handleEvent(event);
 			}
 
-			animationFrame += engine::ui::speedSlider->getValue();
+			// The slider is logarithmic, from 1 to a million tiles per second
+			frameTime = frameClock.restart().asSeconds();
+			animationSpeed = std::pow(10.f, engine::ui::speedSlider->getValue());
 		}
 
 		void close()